@@ -0,0 +1,85 @@
+#pragma once
+
+#include "OutputWriter.h"
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * What a producer does when the output queue is full
+ */
+enum class BackpressurePolicy {
+    BLOCK, // Wait for the writer thread to free a slot
+    DROP,  // Discard the chunk and count its lines
+    SPILL, // Append the chunk, and every later one until it drains, to a temporary file
+};
+
+/**
+ * Output stage that keeps compute threads off a slow descriptor
+ * Producers move formatted chunks into a bounded lock-free MPSC ring; one writer thread drains it
+ * with writev. Spilling keeps every line in order: while the spill file holds undrained chunks, new
+ * chunks are appended behind them instead of jumping ahead through the ring.
+ */
+class AsyncOutputWriter : public IOutputWriter {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    /**
+     * capacity is the number of queued chunks and is rounded up to a power of two
+     * The descriptor is not owned. Throws std::runtime_error if the spill file cannot be created.
+     */
+    explicit AsyncOutputWriter(int fd, BackpressurePolicy policy = BackpressurePolicy::BLOCK,
+                               size_t capacity = DEFAULT_CAPACITY);
+    ~AsyncOutputWriter() override;
+
+    AsyncOutputWriter(const AsyncOutputWriter &) = delete;
+    AsyncOutputWriter &operator=(const AsyncOutputWriter &) = delete;
+
+    /**
+     * Queue a block of whole lines; throws std::runtime_error once the descriptor has failed
+     */
+    void write(std::string_view lines) override;
+    void flush() override;
+
+    uint64_t droppedLines() const { return dropped.load(); }
+    uint64_t spilledBytes() const { return spillEnd.load(); }
+
+    static BackpressurePolicy parsePolicy(const std::string &policy);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        std::string chunk;
+    };
+
+    bool tryPush(std::string &chunk);
+    size_t popBatch(std::string *chunks, size_t maxChunks);
+    void spill(std::string_view lines);
+    bool drainSpill();
+    void writeAll(std::string *chunks, size_t count);
+    void writerLoop(std::stop_token stop);
+
+    int fd;
+    BackpressurePolicy policy;
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    alignas(64) std::atomic<uint64_t> enqueuePos{0};
+    alignas(64) uint64_t dequeuePos = 0;         // Only touched by the writer thread
+    alignas(64) std::atomic<uint64_t> pushed{0}; // Chunks queued; the writer waits on it when idle
+    std::atomic<uint64_t> written{0};            // Chunks the writer has finished
+    std::atomic<uint64_t> progress{0};           // Bumped after every drain; producers and flush wait on it
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> failed{false};
+
+    std::mutex spillMutex;
+    int spillFd = -1;
+    std::atomic<uint64_t> spillEnd{0};
+    std::atomic<uint64_t> spillRead{0};
+
+    std::jthread writer; // Declared last so it stops before the ring goes away
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Segment.h"
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * One line of a batch job file: `start end [output file]`
+ */
+struct BatchQuery {
+    int start = 0;
+    int end = 0;
+    std::string output; // File that receives this query's primes; empty for stdout
+};
+
+/**
+ * Sieve work for a batch: overlapping and adjacent query ranges merged, then split into segments
+ */
+struct BatchPlan {
+    std::vector<std::pair<int, int>> ranges; // Disjoint inclusive ranges in ascending order
+    std::vector<Segment> segments;           // Segments covering ranges, indexed in ascending order
+    long long requested = 0;                 // Sum of query range lengths, before merging
+    long long sieved = 0;                    // Numbers actually sieved
+};
+
+/**
+ * Batch mode: many range queries answered with a single pass over the union of their ranges
+ */
+class BatchPlanner {
+public:
+    /**
+     * Read queries, one per line; blank lines and lines starting with '#' are skipped
+     * Throws std::invalid_argument naming the line for malformed input
+     */
+    static std::vector<BatchQuery> parse(std::istream &input);
+
+    /**
+     * Sort and merge the query ranges into the minimal set of segments
+     */
+    static BatchPlan plan(const std::vector<BatchQuery> &queries, int segmentSize);
+
+    /**
+     * Sieve every segment of the plan once on the shared pool
+     * Returns all primes of the plan in ascending order
+     */
+    static std::vector<int> execute(const BatchPlan &plan, size_t numThreads);
+
+    /**
+     * Primes of one query, as a view into the result of execute
+     */
+    static std::span<const int> primesFor(const std::vector<int> &primes, const BatchQuery &query);
+
+    /**
+     * Send each query's primes to its own output file, or to console under a header line
+     */
+    static void writeResults(const std::vector<BatchQuery> &queries, const std::vector<int> &primes,
+                             std::ostream &console);
+};
@@ -1,7 +1,8 @@
 #pragma once
 
 #include "IPrintStrategy.h"
-#include <iostream>
+#include "OutputWriter.h"
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -9,9 +10,14 @@ class BatchPrintStrategy : public IPrintStrategy {
 private:
     std::vector<int> collectedPrimes;
     std::mutex collectionMutex;
+    std::shared_ptr<IOutputWriter> writer;
 
 public:
+    BatchPrintStrategy();
+    explicit BatchPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter);
+
     void printPrime(int prime, std::thread::id threadId,
                     std::chrono::system_clock::time_point timestamp) override;
-    void finalize(const std::vector<int> &allPrimes) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "IPrintStrategy.h"
+#include "OutputWriter.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * How BinaryPrintStrategy stores each prime
+ */
+enum class BinaryEncoding : uint8_t {
+    U32 = 1,   // Little-endian uint32
+    U64 = 2,   // Little-endian uint64
+    VARINT = 3 // LEB128 gap to the previous prime in the block (GapCodec)
+};
+
+/**
+ * Writes primes as a binary stream instead of text
+ * The stream starts with an 8-byte header: "PRMB", a version byte, the encoding byte and two zero bytes.
+ * Every non-empty segment follows as one block: little-endian uint32 prime count, uint32 payload size,
+ * then the payload. Blocks appear in segment completion order and each decodes on its own, so a
+ * varint block starts from a gap relative to zero.
+ */
+class BinaryPrintStrategy : public IPrintStrategy {
+public:
+    static constexpr std::string_view MAGIC = "PRMB";
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 8;
+    static constexpr size_t BLOCK_HEADER_SIZE = 8;
+
+    /**
+     * Writes the stream header immediately
+     */
+    explicit BinaryPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter,
+                                 BinaryEncoding streamEncoding = BinaryEncoding::VARINT);
+
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
+
+    /**
+     * Bytes handed to the writer so far, header included
+     */
+    uint64_t bytesWritten() const { return written.load(); }
+
+    /**
+     * Parse "u32", "u64" or "varint"; throws std::invalid_argument otherwise
+     */
+    static BinaryEncoding parseEncoding(const std::string &name);
+
+    /**
+     * Decode a whole stream into primes in block order; throws std::invalid_argument on malformed input
+     */
+    static std::vector<int> decode(std::string_view stream);
+
+private:
+    std::shared_ptr<IOutputWriter> writer;
+    BinaryEncoding encoding;
+    std::atomic<uint64_t> written{0};
+};
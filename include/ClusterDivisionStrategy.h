@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ITaskDivisionStrategy.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+class SearchJob;
+
+/**
+ * Coordinator side of cluster mode
+ * Listens on a TCP port and leases segments to `prime_finder --worker host:port` processes.
+ * A lease that is not answered within the lease timeout is handed to another worker; the first
+ * result for a segment wins and late duplicates are ignored.
+ */
+class ClusterDivisionStrategy : public ITaskDivisionStrategy {
+private:
+    static std::mutex consoleMutex;
+    int listenPort;
+    std::chrono::milliseconds leaseTimeout;
+    std::atomic<int> boundPort{0};
+
+public:
+    static constexpr int DEFAULT_PORT = 7878;
+    static constexpr std::chrono::milliseconds DEFAULT_LEASE_TIMEOUT{5000};
+
+    explicit ClusterDivisionStrategy(int port = DEFAULT_PORT,
+                                     std::chrono::milliseconds timeout = DEFAULT_LEASE_TIMEOUT);
+
+    /**
+     * numThreads is unused: parallelism comes from the connected workers
+     */
+    Task<PrimeSearchResult> findPrimesAsync(int upperLimit, int numThreads,
+                                            std::shared_ptr<IPrintStrategy> printStrategy,
+                                            SearchOptions options) override;
+
+    /**
+     * Port the coordinator is listening on; useful when constructed with port 0
+     */
+    int port() const { return boundPort; }
+
+private:
+    static int openListener(int port, int &actualPort);
+    static void coordinate(int listener, int upperLimit, std::chrono::milliseconds leaseTimeout,
+                           SearchJob &job);
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Message types of the coordinator/worker protocol
+ * Every frame is a one-byte type, a little-endian uint32 payload length and the payload
+ */
+enum class ClusterMessage : uint8_t {
+    HELLO = 1,  // worker -> coordinator: ready for work
+    LEASE = 2,  // coordinator -> worker: segment index, start, end, whether primes are wanted
+    RESULT = 3, // worker -> coordinator: segment index, prime count, gap-encoded primes
+    DONE = 4,   // coordinator -> worker: no more work, disconnect
+};
+
+struct LeaseMessage {
+    uint32_t segmentIndex = 0;
+    int32_t start = 0;
+    int32_t end = 0;
+    bool wantPrimes = true;
+};
+
+struct ResultMessage {
+    uint32_t segmentIndex = 0;
+    uint32_t count = 0;
+    std::vector<int> primes; // Empty when only the count was requested
+};
+
+class ClusterProtocol {
+public:
+    static constexpr size_t HEADER_SIZE = 5;
+    static constexpr uint32_t MAX_PAYLOAD = 64 * 1024 * 1024;
+
+    static std::string frame(ClusterMessage type, std::string_view payload = {});
+
+    static std::string encodeLease(const LeaseMessage &lease);
+    static bool decodeLease(std::string_view payload, LeaseMessage &lease);
+
+    /**
+     * Encode a segment result; primes are gap-encoded relative to the segment start
+     */
+    static std::string encodeResult(uint32_t segmentIndex, int segmentStart, const std::vector<int> &primes,
+                                    bool includePrimes);
+
+    /**
+     * Encode a count-only result, answering a lease that did not want the primes
+     */
+    static std::string encodeCount(uint32_t segmentIndex, uint32_t count);
+    static bool decodeResult(std::string_view payload, int segmentStart, ResultMessage &result);
+
+    /**
+     * Read the segment index of a result without decoding it, to look up the segment start
+     */
+    static bool peekSegmentIndex(std::string_view payload, uint32_t &segmentIndex);
+
+    /**
+     * Remove one complete frame from the front of buffer
+     * Returns false when more bytes are needed; throws on an oversized frame
+     */
+    static bool takeFrame(std::string &buffer, ClusterMessage &type, std::string &payload);
+
+    /**
+     * Blocking helpers for sockets; return false when the peer is gone
+     */
+    static bool sendAll(int fd, std::string_view data);
+    static bool receiveFrame(int fd, ClusterMessage &type, std::string &payload);
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Worker side of cluster mode
+ * Connects to a coordinator, sieves leased segments and streams back gap-encoded results
+ */
+class ClusterWorker {
+public:
+    /**
+     * Serve leases over the given number of connections until the coordinator says DONE
+     * Returns the number of segments processed, or -1 if no connection could be made
+     */
+    static long run(const std::string &host, int port, int connections = 1);
+
+    /**
+     * Parse "host:port"; returns false when malformed
+     */
+    static bool parseAddress(const std::string &address, std::string &host, int &port);
+
+private:
+    static long serveConnection(const std::string &host, int port);
+    static int connectTo(const std::string &host, int port);
+};
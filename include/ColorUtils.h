@@ -1,57 +1,70 @@
 #pragma once
 
-#include <iostream>
 #include <string>
+#include <string_view>
 
 class ColorUtils {
 public:
     // ANSI Color Codes
-    static const std::string RESET;
-    static const std::string BOLD;
+    static constexpr std::string_view RESET = "\033[0m";
+    static constexpr std::string_view BOLD = "\033[1m";
 
     // Text Colors
-    static const std::string RED;
-    static const std::string GREEN;
-    static const std::string YELLOW;
-    static const std::string BLUE;
-    static const std::string MAGENTA;
-    static const std::string CYAN;
-    static const std::string WHITE;
-    static const std::string GRAY;
+    static constexpr std::string_view RED = "\033[31m";
+    static constexpr std::string_view GREEN = "\033[32m";
+    static constexpr std::string_view YELLOW = "\033[33m";
+    static constexpr std::string_view BLUE = "\033[34m";
+    static constexpr std::string_view MAGENTA = "\033[35m";
+    static constexpr std::string_view CYAN = "\033[36m";
+    static constexpr std::string_view WHITE = "\033[37m";
+    static constexpr std::string_view GRAY = "\033[90m";
 
     // Background Colors
-    static const std::string BG_RED;
-    static const std::string BG_GREEN;
-    static const std::string BG_YELLOW;
-    static const std::string BG_BLUE;
-    static const std::string BG_MAGENTA;
-    static const std::string BG_CYAN;
+    static constexpr std::string_view BG_RED = "\033[41m";
+    static constexpr std::string_view BG_GREEN = "\033[42m";
+    static constexpr std::string_view BG_YELLOW = "\033[43m";
+    static constexpr std::string_view BG_BLUE = "\033[44m";
+    static constexpr std::string_view BG_MAGENTA = "\033[45m";
+    static constexpr std::string_view BG_CYAN = "\033[46m";
 
     // Bright Colors
-    static const std::string BRIGHT_RED;
-    static const std::string BRIGHT_GREEN;
-    static const std::string BRIGHT_YELLOW;
-    static const std::string BRIGHT_BLUE;
-    static const std::string BRIGHT_MAGENTA;
-    static const std::string BRIGHT_CYAN;
-    static const std::string BRIGHT_WHITE;
+    static constexpr std::string_view BRIGHT_RED = "\033[91m";
+    static constexpr std::string_view BRIGHT_GREEN = "\033[92m";
+    static constexpr std::string_view BRIGHT_YELLOW = "\033[93m";
+    static constexpr std::string_view BRIGHT_BLUE = "\033[94m";
+    static constexpr std::string_view BRIGHT_MAGENTA = "\033[95m";
+    static constexpr std::string_view BRIGHT_CYAN = "\033[96m";
+    static constexpr std::string_view BRIGHT_WHITE = "\033[97m";
+
+    /**
+     * The styles behind the helper functions, one escape sequence each
+     */
+    enum class Style { BOLD, ERROR, SUCCESS, WARNING, INFO, HIGHLIGHT, PRIME, THREAD, TIMESTAMP };
 
     // Helper functions
-    static std::string colorize(const std::string &text, const std::string &color);
-    static std::string bold(const std::string &text);
-    static std::string error(const std::string &text);
-    static std::string success(const std::string &text);
-    static std::string warning(const std::string &text);
-    static std::string info(const std::string &text);
-    static std::string highlight(const std::string &text);
-    static std::string prime(const std::string &text);
-    static std::string thread(const std::string &text);
-    static std::string timestamp(const std::string &text);
+    static std::string colorize(std::string_view text, std::string_view color);
+    static std::string bold(std::string_view text);
+    static std::string error(std::string_view text);
+    static std::string success(std::string_view text);
+    static std::string warning(std::string_view text);
+    static std::string info(std::string_view text);
+    static std::string highlight(std::string_view text);
+    static std::string prime(std::string_view text);
+    static std::string thread(std::string_view text);
+    static std::string timestamp(std::string_view text);
+
+    // Append styled text to out without temporary strings
+    static void append(std::string &out, std::string_view text, Style style);
+
+    // Raw codes for callers that color many values at once; empty when colors are disabled
+    static std::string_view code(Style style);
+    static std::string_view primeColor();
+    static std::string_view resetColor();
 
     // Check if colors should be enabled (can be disabled for non-terminal output)
     static bool isColorEnabled();
     static void setColorEnabled(bool enabled);
 
 private:
-    static bool colorEnabled;
+    static bool colorActive; // Enabled and standard output is a terminal
 };
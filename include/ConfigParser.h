@@ -4,9 +4,24 @@
 
 struct Config {
     int threads = 4;
+    bool autoThreads = false;  // true when threads = "auto"
+    std::string threadsReason; // How the automatic thread count was chosen
     int upperLimit = 1000;
-    std::string printMode = "immediate"; // "immediate" or "batch"
-    std::string divisionMode = "range";  // "range" or "queue"
+    std::string printMode = "immediate";    // Output format, see config.toml
+    std::string divisionMode = "range";     // "range", "queue", "process" or "cluster"
+    int progressIntervalMs = 0;             // 0 disables progress reports
+    std::string progressOutput = "stderr";  // "stderr" or a file path
+    int clusterPort = 7878;                 // Coordinator port in cluster mode
+    int leaseTimeoutMs = 5000;              // Re-dispatch a cluster lease after this long
+    std::string outputBackpressure = "off"; // Async output: "off", "block", "drop" or "spill"
+    std::string outputIo = "write";         // "write", or "uring" for io_uring with in-flight buffers
+    std::string outputFile;                 // Write primes here instead of standard output
+    std::string binaryEncoding = "varint";  // Binary print mode: "u32", "u64" or "varint"
+    int reorderWindow = 64;                 // Ordered print mode: segments held while waiting for order
+    int frameRate = 10;                     // Live print mode: status line redraws per second
+    std::string shardDir = "primes_shards"; // Sharded print mode: directory for shards and manifest
+    std::string shardFormat = "text";       // Sharded print mode: "text" or "u32"
+    int cacheLimit = 100000000;             // Query daemon: never cache past this or upper_limit
 };
 
 class ConfigParser {
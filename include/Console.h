@@ -0,0 +1,25 @@
+#pragma once
+
+#include <iostream>
+
+/**
+ * Destination for status messages: banners, per-thread progress lines and summaries
+ * Standard output by default; structured output modes move them to standard error so that standard
+ * output carries nothing but records. While muted they are discarded, e.g. while a live status line
+ * is being redrawn.
+ */
+class Console {
+public:
+    static std::ostream &status();
+    static void setStatusToStderr(bool enabled);
+    static bool statusToStderr() { return toStderr; }
+
+    /**
+     * Discard status messages until unmuted; set only while no search is running
+     */
+    static void setStatusMuted(bool enabled);
+
+private:
+    static bool toStderr;
+    static bool muted;
+};
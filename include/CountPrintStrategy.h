@@ -0,0 +1,23 @@
+#pragma once
+
+#include "OutputWriter.h"
+#include "ResultSinks.h"
+#include <chrono>
+#include <memory>
+
+/**
+ * Prints only how many primes were found and how long the search took
+ * As a CountingSink it puts range and queue searches on their sieve-and-popcount path, which makes
+ * print_mode = "count" a pure compute benchmark.
+ */
+class CountPrintStrategy : public CountSink {
+public:
+    CountPrintStrategy();
+    explicit CountPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter);
+
+    void finalize(const SearchSummary &summary) override;
+
+private:
+    std::shared_ptr<IOutputWriter> writer;
+    std::chrono::steady_clock::time_point started;
+};
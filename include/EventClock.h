@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+/**
+ * Cheap, monotonic event timestamps for finished segments
+ * now() reads the steady clock and maps it onto wall-clock time through one anchor taken at startup,
+ * so timestamps never jump backwards and keep nanosecond resolution. Rendering caches the calendar
+ * text of the current second per thread; only the elapsed-since-start part is formatted per event.
+ */
+class EventClock {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    static TimePoint now();
+
+    /**
+     * Time since the anchor was taken, at nanosecond resolution
+     */
+    static std::chrono::nanoseconds sinceStart(TimePoint timestamp);
+
+    /**
+     * Append the calendar time, e.g. "Mon Oct 19 12:00:00 2026", reusing this thread's text for the second
+     */
+    static void appendWallClock(std::string &out, TimePoint timestamp);
+
+    /**
+     * Append the time since start as "+S.NNNNNNNNNs"
+     */
+    static void appendElapsed(std::string &out, TimePoint timestamp);
+};
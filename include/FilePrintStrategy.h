@@ -0,0 +1,60 @@
+#pragma once
+
+#include "IPrintStrategy.h"
+#include "OutputWriter.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * Writes one ordered text file, one prime per line, without funnelling the text through one stream
+ * Worker threads format their segments as they finish. File offsets are a running prefix sum over
+ * segment sizes in index order: the worker that delivers the next segment in order claims it and
+ * every held segment that now follows, advances the sum under a short lock and writes the run with
+ * pwritev outside it, so workers write in parallel and text leaves memory as soon as it is placed.
+ * Segments that arrive ahead of an unfinished earlier one are held until it is written; with range
+ * division that can be most of a later worker's output.
+ */
+class FilePrintStrategy : public IPrintStrategy {
+public:
+    /**
+     * Create or truncate path; the summary line goes to statusWriter, or standard output when null
+     * Throws std::runtime_error when the file cannot be opened.
+     */
+    explicit FilePrintStrategy(const std::string &path,
+                               std::shared_ptr<IOutputWriter> statusWriter = nullptr);
+    ~FilePrintStrategy() override;
+
+    /**
+     * Append a lone prime at the current end of the placed text; it has no place in the segment order
+     */
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+
+    /**
+     * Format the segment and write it, with any held segments that follow, once its offset is known
+     * Throws std::runtime_error when a write fails.
+     */
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+
+    /**
+     * Write the segments still held after a stopped search, closing the gaps; throws
+     * std::runtime_error when a write fails
+     */
+    void finalize(const SearchSummary &summary) override;
+
+private:
+    void writeRun(const std::vector<std::string> &run, off_t offset) const;
+
+    std::string path;
+    int fd = -1;
+    std::shared_ptr<IOutputWriter> writer;
+
+    std::mutex placeMutex;
+    std::map<int, std::string> held; // Formatted segments waiting for an earlier one, by index
+    int nextIndex = 0;               // First segment whose offset is not known yet
+    off_t placedBytes = 0;           // Bytes claimed so far; the next segment's offset
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Compact encoding for ascending prime lists
+ * Each prime is stored as the LEB128 varint of its gap to the previous value, so most primes take one byte
+ */
+class GapCodec {
+public:
+    /**
+     * Append an unsigned LEB128 varint
+     */
+    static void appendVarint(std::string &out, uint64_t value);
+
+    /**
+     * Read an unsigned LEB128 varint, advancing pos; returns false on truncated or oversized input
+     */
+    static bool readVarint(std::string_view in, size_t &pos, uint64_t &value);
+
+    /**
+     * Append ascending primes as gaps relative to base (the first gap is primes[0] - base)
+     */
+    static void encodeGaps(std::string &out, std::span<const int> primes, int64_t base);
+
+    /**
+     * Decode count gap-encoded primes starting at pos; returns false on malformed input
+     */
+    static bool decodeGaps(std::string_view in, size_t &pos, size_t count, int64_t base,
+                           std::vector<int> &primes);
+};
@@ -1,13 +1,48 @@
 #pragma once
 
+#include "Segment.h"
 #include <chrono>
+#include <span>
+#include <cstddef>
 #include <thread>
-#include <vector>
 
+/**
+ * Where a batch of primes delivered to a print strategy came from
+ */
+struct SegmentInfo {
+    Segment segment;                                 // Candidates the primes were found in
+    int worker = 0;                                  // Worker index within the search
+    std::thread::id threadId;                        // Thread delivering the batch
+    std::chrono::system_clock::time_point timestamp; // When the segment was finished
+};
+
+/**
+ * Totals handed to a print strategy once the search is over
+ */
+struct SearchSummary {
+    size_t primeCount = 0;
+    bool complete = true;
+};
+
+/**
+ * Receives the results of a search as they are found
+ * Nothing is materialized for the caller unless the strategy itself keeps the primes.
+ */
 class IPrintStrategy {
 public:
     virtual ~IPrintStrategy() = default;
     virtual void printPrime(int prime, std::thread::id threadId,
                             std::chrono::system_clock::time_point timestamp) = 0;
-    virtual void finalize(const std::vector<int> &allPrimes) = 0;
+
+    /**
+     * Receive all primes of one finished segment, in ascending order; called for empty segments too
+     * The default forwards each prime to printPrime, so per-prime strategies keep working.
+     */
+    virtual void printPrimes(std::span<const int> primes, const SegmentInfo &info) {
+        for (int prime : primes) {
+            printPrime(prime, info.threadId, info.timestamp);
+        }
+    }
+
+    virtual void finalize(const SearchSummary &summary) = 0;
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "SearchOptions.h"
+#include "Task.h"
 #include <memory>
 #include <vector>
 
@@ -8,6 +10,27 @@ class IPrintStrategy;
 class ITaskDivisionStrategy {
 public:
     virtual ~ITaskDivisionStrategy() = default;
-    virtual std::vector<int> findPrimes(int upperLimit, int numThreads,
-                                        std::shared_ptr<IPrintStrategy> printStrategy) = 0;
+
+    /**
+     * Start a search on the shared thread pool and return immediately
+     * numThreads is the number of pool workers the search may occupy at once
+     */
+    virtual Task<PrimeSearchResult> findPrimesAsync(int upperLimit, int numThreads,
+                                                    std::shared_ptr<IPrintStrategy> printStrategy,
+                                                    SearchOptions options) = 0;
+
+    // Block until the search finishes. Do not call from a pool worker; chain on findPrimesAsync instead.
+    PrimeSearchResult findPrimes(int upperLimit, int numThreads,
+                                 std::shared_ptr<IPrintStrategy> printStrategy,
+                                 const SearchOptions &options) {
+        return findPrimesAsync(upperLimit, numThreads, std::move(printStrategy), options).take();
+    }
+
+    // Run to completion and return only the primes; a thin wrapper that asks the search to collect them.
+    std::vector<int> findPrimes(int upperLimit, int numThreads,
+                                std::shared_ptr<IPrintStrategy> printStrategy) {
+        SearchOptions options;
+        options.collectPrimes = true;
+        return findPrimes(upperLimit, numThreads, std::move(printStrategy), options).primes;
+    }
 };
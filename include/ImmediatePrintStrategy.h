@@ -1,16 +1,60 @@
 #pragma once
 
 #include "IPrintStrategy.h"
-#include <iomanip>
-#include <iostream>
+#include "OutputWriter.h"
+#include <chrono>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 
+/**
+ * Prints every prime as its own line with thread and timestamp
+ * Lines are formatted into a per-thread buffer and handed to the writer in large blocks, once a
+ * buffer reaches flushBytes or has waited flushInterval; finalize flushes everything.
+ */
 class ImmediatePrintStrategy : public IPrintStrategy {
-private:
-    std::mutex printMutex;
-
 public:
+    static constexpr size_t DEFAULT_FLUSH_BYTES = 64 * 1024;
+    static constexpr std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{50};
+
+    ImmediatePrintStrategy();
+    explicit ImmediatePrintStrategy(std::shared_ptr<IOutputWriter> outputWriter,
+                                    size_t flushBytes = DEFAULT_FLUSH_BYTES,
+                                    std::chrono::milliseconds flushInterval = DEFAULT_FLUSH_INTERVAL);
+    ~ImmediatePrintStrategy() override;
+
     void printPrime(int prime, std::thread::id threadId,
                     std::chrono::system_clock::time_point timestamp) override;
-    void finalize(const std::vector<int> &allPrimes) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
+
+    /**
+     * Append one immediate-mode line per prime, all with the same thread and timestamp
+     * The timestamp is when the segment was finished and is labelled as such on every line.
+     */
+    static void formatLines(std::string &out, std::span<const int> primes, std::thread::id threadId,
+                            std::chrono::system_clock::time_point timestamp);
+
+private:
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::string lines;
+        std::chrono::steady_clock::time_point lastFlush = std::chrono::steady_clock::now();
+    };
+
+    ThreadBuffer &bufferFor(std::thread::id threadId);
+    void flushBuffer(ThreadBuffer &buffer);
+    void flushAll(bool onlyStale);
+    void startFlusher();
+
+    std::shared_ptr<IOutputWriter> writer;
+    size_t flushBytes;
+    std::chrono::milliseconds flushInterval;
+
+    std::mutex buffersMutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadBuffer>> buffers;
+    std::once_flag flusherStarted;
+    std::jthread flusher; // Declared last so it stops before the buffers go away
 };
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+/**
+ * Offline query: count the primes in [start, end], or list them as well
+ */
+struct IntervalQuery {
+    int start = 0;
+    int end = 0;
+    bool listPrimes = false;
+};
+
+struct IntervalAnswer {
+    uint64_t count = 0;
+    std::vector<int> primes; // Only filled for listing queries
+};
+
+/**
+ * Answers many small interval queries with one sweep of the sieve
+ * Queries are sorted by position and the sieve visits each aligned segment that any query touches
+ * exactly once, in ascending order. Per-word prefix counts answer every query intersecting the
+ * current segment in O(1). Needed segments are split into contiguous runs, one per thread.
+ */
+class IntervalQueryEngine {
+public:
+    // Multiple of 64 so segments line up with bitmap words.
+    static constexpr int DEFAULT_SEGMENT_SIZE = 1 << 18;
+
+    /**
+     * Answer every query; answers are returned in query order
+     */
+    static std::vector<IntervalAnswer> answer(const std::vector<IntervalQuery> &queries, int numThreads,
+                                              int segmentSize = DEFAULT_SEGMENT_SIZE);
+
+    /**
+     * Read queries, one `count start end` or `list start end` per line; '#' starts a comment
+     * Throws std::invalid_argument naming the line for malformed input
+     */
+    static std::vector<IntervalQuery> parse(std::istream &input);
+
+    /**
+     * Write one line per answer: the count, followed by the primes for listing queries
+     */
+    static void write(const std::vector<IntervalQuery> &queries, const std::vector<IntervalAnswer> &answers,
+                      std::ostream &output);
+};
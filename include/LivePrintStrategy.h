@@ -0,0 +1,65 @@
+#pragma once
+
+#include "IPrintStrategy.h"
+#include "OutputWriter.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Shows progress at a fixed frame rate instead of one line per prime
+ * Workers only update counters and a small ring of recent primes, never waiting on the terminal. A
+ * background thread draws a status line frameRate times a second: redrawn in place when standard
+ * output is a terminal, one line per frame otherwise. When fullResults is given every prime is also
+ * passed on to it, so the complete list can go to a file while the terminal shows the live view.
+ */
+class LivePrintStrategy : public IPrintStrategy {
+public:
+    static constexpr int DEFAULT_FRAME_RATE = 10;
+    static constexpr size_t RECENT_PRIMES = 5;
+
+    LivePrintStrategy();
+    explicit LivePrintStrategy(std::shared_ptr<IOutputWriter> outputWriter,
+                               std::shared_ptr<IPrintStrategy> fullResults = nullptr,
+                               int frameRate = DEFAULT_FRAME_RATE);
+    ~LivePrintStrategy() override;
+
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
+
+    /**
+     * Number of frames drawn so far
+     */
+    size_t framesDrawn() const { return frames.load(); }
+
+private:
+    void countPrimes(std::span<const int> primes);
+    std::string renderFrame();
+    void drawFrame();
+    void startRenderer();
+
+    std::shared_ptr<IOutputWriter> writer;
+    std::shared_ptr<IPrintStrategy> fullResults;
+    std::chrono::milliseconds frameInterval;
+    bool redraw; // Standard output is a terminal: overwrite one line instead of printing new ones
+
+    std::atomic<uint64_t> primeCount{0};
+    std::atomic<int> largest{0};
+    std::atomic<size_t> frames{0};
+    std::chrono::steady_clock::time_point started;
+
+    std::mutex recentMutex; // Only ever try-locked by workers
+    std::array<int, RECENT_PRIMES> recent{};
+    size_t recentCount = 0;
+
+    uint64_t lastDrawnCount = UINT64_MAX; // Renderer thread only
+    std::once_flag rendererStarted;
+    std::jthread renderer; // Declared last so it stops before the state it reads goes away
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "IPrintStrategy.h"
+#include "OutputWriter.h"
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Immediate-mode lines in ascending order, streamed as soon as the order allows
+ * Segments are formatted as they arrive and held, keyed by segment index, until every earlier segment
+ * has been written. Queue searches compiled for this sink call awaitWindow before starting a segment,
+ * so at most window segments are ever held; range searches reject it, since their waiting workers
+ * would park shared pool threads. Other searches are reordered without that bound.
+ * Single primes passed to printPrime carry no segment and are written straight away.
+ */
+class OrderedPrintStrategy : public IPrintStrategy {
+public:
+    static constexpr int DEFAULT_WINDOW = 64;
+
+    OrderedPrintStrategy();
+    explicit OrderedPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter, int window = DEFAULT_WINDOW);
+
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
+
+    /**
+     * Block until segmentIndex is inside the reorder window; returns false as soon as shouldStop does
+     */
+    bool awaitWindow(int segmentIndex, const std::function<bool()> &shouldStop);
+
+    /**
+     * Largest number of segments held at once so far
+     */
+    size_t peakHeldSegments() const;
+
+private:
+    std::shared_ptr<IOutputWriter> writer;
+    int window;
+
+    mutable std::mutex mutex;
+    std::condition_variable advanced;
+    std::map<int, std::string> held; // Formatted segments waiting for an earlier one
+    int nextIndex = 0;
+    size_t peakHeld = 0;
+};
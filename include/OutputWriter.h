@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+
+/**
+ * Destination for formatted output
+ * Callers hand over blocks of whole lines; blocks from different threads never interleave.
+ */
+class IOutputWriter {
+public:
+    virtual ~IOutputWriter() = default;
+    virtual void write(std::string_view lines) = 0;
+
+    /**
+     * Write several pieces as one block, for callers that would otherwise copy them together
+     * The default concatenates and calls write.
+     */
+    virtual void writeParts(std::span<const std::string_view> parts) {
+        std::string block;
+        for (std::string_view part : parts) {
+            block.append(part);
+        }
+        write(block);
+    }
+
+    /**
+     * Block until everything written so far has reached its destination
+     */
+    virtual void flush() {}
+};
+
+/**
+ * Writes blocks straight to a file descriptor with write(2), retrying partial writes
+ * A wrapped descriptor is not owned; one opened by openFile is closed with the writer.
+ */
+class FdOutputWriter : public IOutputWriter {
+public:
+    explicit FdOutputWriter(int fd);
+    ~FdOutputWriter() override;
+
+    /**
+     * Create or truncate path and write to it; throws std::runtime_error when it cannot be opened
+     */
+    static std::shared_ptr<FdOutputWriter> openFile(const std::string &path);
+
+    void write(std::string_view lines) override;
+    void writeParts(std::span<const std::string_view> parts) override;
+
+    uint64_t bytesWritten() const { return written.load(); }
+
+private:
+    int fd;
+    bool ownsFd = false;
+    std::mutex writeMutex;
+    std::atomic<uint64_t> written{0};
+};
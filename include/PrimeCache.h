@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+/**
+ * In-memory prime bitmap with per-word prefix counts
+ * Answers primality, counting, listing, nth-prime and next-prime queries in O(1) or O(log n) once a
+ * range is cached. The cache grows on demand by sieving new chunks in parallel on a thread pool, but
+ * never past its ceiling, so one query cannot stall the caller sieving up to MAX_LIMIT.
+ * Not thread-safe: use from one thread, and never from a worker of the pool it sieves on.
+ */
+class PrimeCache {
+public:
+    static constexpr int64_t MAX_LIMIT = std::numeric_limits<int>::max();
+
+    /**
+     * ceiling is the largest number the cache will ever hold, at most MAX_LIMIT
+     */
+    explicit PrimeCache(ThreadPool &pool = ThreadPool::shared(), int64_t ceiling = MAX_LIMIT);
+
+    /**
+     * Make sure every number in [0, min(n, ceiling())] is cached
+     */
+    void ensure(int64_t n);
+
+    /**
+     * Highest number currently cached, or -1 when empty
+     */
+    int64_t limit() const { return static_cast<int64_t>(bits.size()) * 64 - 1; }
+
+    /**
+     * Largest number queries may ask about; isPrime, count and collect require arguments up to it
+     */
+    int64_t ceiling() const { return maxCached; }
+
+    bool isPrime(int n);
+
+    /**
+     * Number of primes in [low, high] (inclusive)
+     */
+    uint32_t count(int low, int high);
+
+    /**
+     * Append the primes in [low, high] to out; returns false without appending if more than maxPrimes
+     */
+    bool collect(int low, int high, size_t maxPrimes, std::vector<uint32_t> &out);
+
+    /**
+     * The k-th prime (1-based), or nothing if it exceeds ceiling()
+     */
+    std::optional<int> nthPrime(uint32_t k);
+
+    /**
+     * Smallest prime strictly greater than n, or nothing if it exceeds ceiling()
+     */
+    std::optional<int> nextPrime(int n);
+
+private:
+    static constexpr int64_t CHUNK_SIZE = 1 << 18;
+
+    // Number of primes below n; n must be cached or one past the cache.
+    uint32_t primesBelow(int64_t n) const;
+
+    ThreadPool &pool;
+    int64_t maxCached;
+    std::vector<uint64_t> bits;        // Bit n is set when n is prime
+    std::vector<uint32_t> wordPrefix;  // Primes below word i
+};
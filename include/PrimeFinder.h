@@ -0,0 +1,48 @@
+#pragma once
+
+#include "SearchOptions.h"
+#include "SinkPolicy.h"
+#include "Task.h"
+#include <concepts>
+#include <memory>
+#include <utility>
+
+/**
+ * A division strategy that can run its search with the sink type as a template parameter
+ */
+template <typename Division, typename Sink>
+concept DivisionPolicy = requires(Division division, std::shared_ptr<Sink> sink, SearchOptions options) {
+    { division.template findPrimesWith<Sink>(0, 1, sink, options) } -> std::same_as<Task<PrimeSearchResult>>;
+};
+
+/**
+ * Prime search with the division strategy and sink fixed at compile time
+ * The hot loop reports primes to the sink without virtual dispatch. Combinations must be instantiated
+ * by the division strategy (see PRIME_FINDER_SINKS in SegmentStep.h); the virtual interfaces remain
+ * for plugins and the remaining modes.
+ */
+template <typename Division, typename Sink>
+    requires SinkPolicy<Sink> && DivisionPolicy<Division, Sink>
+class PrimeFinder {
+public:
+    /**
+     * Create the sink from the given constructor arguments
+     */
+    template <typename... SinkArgs>
+    explicit PrimeFinder(SinkArgs &&...sinkArgs)
+        : sinkPolicy(std::make_shared<Sink>(std::forward<SinkArgs>(sinkArgs)...)) {}
+
+    Task<PrimeSearchResult> findPrimesAsync(int upperLimit, int numThreads, SearchOptions options = {}) {
+        return division.template findPrimesWith<Sink>(upperLimit, numThreads, sinkPolicy, std::move(options));
+    }
+
+    PrimeSearchResult findPrimes(int upperLimit, int numThreads, const SearchOptions &options = {}) {
+        return findPrimesAsync(upperLimit, numThreads, options).take();
+    }
+
+    Sink &sink() { return *sinkPolicy; }
+
+private:
+    Division division;
+    std::shared_ptr<Sink> sinkPolicy;
+};
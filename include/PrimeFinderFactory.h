@@ -1,20 +1,44 @@
 #pragma once
 
+#include "SearchOptions.h"
+#include "Task.h"
 #include <memory>
 #include <string>
 
 class ITaskDivisionStrategy;
 class IPrintStrategy;
+class IOutputWriter;
+struct Config;
 
-enum class PrintMode { IMMEDIATE, BATCH };
+enum class PrintMode { IMMEDIATE, BATCH, BINARY, TEXT_FILE, COUNT, ORDERED, LIVE, SHARDED, NDJSON, CSV };
 
-enum class DivisionMode { RANGE, QUEUE };
+enum class DivisionMode { RANGE, QUEUE, PROCESS, CLUSTER };
 
 class PrimeFinderFactory {
 public:
     static std::shared_ptr<IPrintStrategy> createPrintStrategy(PrintMode mode);
+    static std::shared_ptr<IPrintStrategy> createPrintStrategy(PrintMode mode,
+                                                               std::shared_ptr<IOutputWriter> writer);
+
+    // Create the print strategy selected by a configuration, applying its mode-specific settings.
+    static std::shared_ptr<IPrintStrategy> createPrintStrategy(const Config &config,
+                                                               std::shared_ptr<IOutputWriter> writer);
+
+    // The configured output file, or standard output behind an async writer thread unless
+    // output_backpressure is "off". Binary output goes to primes.bin when no file is configured;
+    // in file, live and sharded modes the print strategy owns the files and this writer only gets the summary
+    // and live frames. output_io = "uring" swaps in a UringOutputWriter for the file or standard output.
+    static std::shared_ptr<IOutputWriter> createOutputWriter(const Config &config);
     static std::shared_ptr<ITaskDivisionStrategy> createDivisionStrategy(DivisionMode mode);
 
+    // Create the division strategy selected by a configuration, applying its mode-specific settings.
+    static std::shared_ptr<ITaskDivisionStrategy> createDivisionStrategy(const Config &config);
+
+    // Run the configured search, dispatching once to a compile-time PrimeFinder where one exists.
+    // Print strategies write to writer, or to createOutputWriter(config) when it is null.
+    static Task<PrimeSearchResult> findPrimesAsync(const Config &config, SearchOptions options,
+                                                   std::shared_ptr<IOutputWriter> writer = nullptr);
+
     // Helper functions to parse modes from strings
     static PrintMode parsePrintMode(const std::string &mode);
     static DivisionMode parseDivisionMode(const std::string &mode);
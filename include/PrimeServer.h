@@ -0,0 +1,47 @@
+#pragma once
+
+#include "PrimeCache.h"
+#include "QueryProtocol.h"
+#include <cstdint>
+#include <stop_token>
+#include <string>
+
+/**
+ * Query daemon behind `prime_finder --serve`
+ * Answers QueryProtocol requests over a Unix domain socket from a warm PrimeCache. Clients may
+ * pipeline: every complete request in a read is answered and the responses go out in one write.
+ */
+class PrimeServer {
+public:
+    static constexpr const char *DEFAULT_SOCKET_PATH = "/tmp/prime_finder.sock";
+    static constexpr size_t MAX_RANGE_VALUES = 1 << 20;
+
+    explicit PrimeServer(PrimeCache &cache);
+    ~PrimeServer();
+
+    PrimeServer(const PrimeServer &) = delete;
+    PrimeServer &operator=(const PrimeServer &) = delete;
+
+    /**
+     * Bind the socket, replacing a stale socket file; returns false on failure
+     */
+    bool listen(const std::string &path);
+
+    /**
+     * Serve clients until stop is requested
+     */
+    void run(std::stop_token stop);
+
+    /**
+     * Answer one request from the cache
+     */
+    QueryResponse answer(const QueryRequest &request);
+
+    uint64_t requestsServed() const { return served; }
+
+private:
+    PrimeCache &cache;
+    std::string socketPath;
+    int listener = -1;
+    uint64_t served = 0;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 class PrimeUtils {
@@ -23,6 +24,35 @@ public:
      */
     static std::vector<int> getKnownPrimes(int limit);
 
+    /**
+     * Segmented Sieve of Eratosthenes over [start, end) into a bitmap
+     * Bit i of bits (64 per word, low bit first) is set when start + i is prime.
+     * basePrimes must contain every prime up to sqrt(end - 1); bits must hold (end - start + 63) / 64 words.
+     */
+    static void sieveSegment(int64_t start, int64_t end, const std::vector<int> &basePrimes, uint64_t *bits);
+
+    /**
+     * Append the primes marked in a sieveSegment bitmap of length numbers starting at start
+     */
+    static void appendSegmentPrimes(int64_t start, int64_t length, const uint64_t *bits,
+                                    std::vector<int> &out);
+
+    /**
+     * Count the primes marked in a sieveSegment bitmap of length numbers with popcount
+     */
+    static size_t countSegmentPrimes(int64_t length, const uint64_t *bits);
+
+    /**
+     * Sieve [start, end) into scratch, resized as needed, and return the number of primes
+     */
+    static size_t countPrimesInSegment(int64_t start, int64_t end, const std::vector<int> &basePrimes,
+                                       std::vector<uint64_t> &scratch);
+
+    /**
+     * The base primes sieveSegment needs for segments ending at or below limit + 1
+     */
+    static std::vector<int> basePrimesFor(int limit);
+
 private:
     /**
      * Optimized prime checking using trial division
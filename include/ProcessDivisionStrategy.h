@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ITaskDivisionStrategy.h"
+#include <functional>
+#include <mutex>
+
+class SearchJob;
+
+/**
+ * Fans a search out to forked worker processes
+ * Workers claim segments from a shared-memory queue and set bits in a shared mmap'd bitmap;
+ * the coordinator merges the bitmap into the print strategy. Segments of crashed workers are
+ * reassigned to replacement workers, up to MAX_SEGMENT_ATTEMPTS tries per segment.
+ */
+class ProcessDivisionStrategy : public ITaskDivisionStrategy {
+private:
+    static std::mutex consoleMutex;
+    std::function<void(const Segment &, int)> segmentHook;
+
+public:
+    static constexpr int MAX_SEGMENT_ATTEMPTS = 3;
+
+    Task<PrimeSearchResult> findPrimesAsync(int upperLimit, int numThreads,
+                                            std::shared_ptr<IPrintStrategy> printStrategy,
+                                            SearchOptions options) override;
+
+    /**
+     * Run a callback in the worker process before each segment, with the attempt number (1-based)
+     * Intended for fault injection in tests
+     */
+    void setSegmentHook(std::function<void(const Segment &, int)> hook);
+
+private:
+    static void coordinate(int upperLimit, int numProcesses, SearchJob &job,
+                           const std::function<void(const Segment &, int)> &hook);
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ProgressTracker.h"
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Background thread that samples a ProgressTracker and prints rate and ETA
+ * Output goes to stderr, or to a file when a path is given
+ */
+class ProgressReporter {
+public:
+    ProgressReporter(std::shared_ptr<const ProgressTracker> tracker, std::chrono::milliseconds interval,
+                     const std::string &outputPath = "stderr");
+    ~ProgressReporter();
+
+    ProgressReporter(const ProgressReporter &) = delete;
+    ProgressReporter &operator=(const ProgressReporter &) = delete;
+
+    /**
+     * Print a final report and stop the sampling thread
+     */
+    void stop();
+
+    /**
+     * Render one progress line from two samples taken interval apart, elapsed after the start
+     */
+    static std::string formatReport(const ProgressTracker::Snapshot &current,
+                                    const ProgressTracker::Snapshot &previous,
+                                    std::chrono::duration<double> interval,
+                                    std::chrono::duration<double> elapsed);
+
+private:
+    void run();
+    void report(ProgressTracker::Snapshot &previous, std::chrono::steady_clock::time_point &previousTime);
+
+    std::shared_ptr<const ProgressTracker> tracker;
+    std::chrono::milliseconds interval;
+    std::ofstream file;
+    std::ostream *output;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+    std::thread thread;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Lock-free progress counters for a running search
+ * Each worker updates its own cache-line-sized slot once per segment, so workers never share a line
+ */
+class ProgressTracker {
+public:
+    struct Snapshot {
+        uint64_t candidates = 0;
+        uint64_t segments = 0;
+        uint64_t primes = 0;
+        uint64_t totalCandidates = 0;
+        uint64_t totalSegments = 0;
+    };
+
+    explicit ProgressTracker(int workers);
+
+    /**
+     * Announce the size of the search so reporters can compute percentages and ETA
+     */
+    void setTotals(uint64_t candidates, uint64_t segments);
+
+    /**
+     * Record a finished segment in the given worker's slot
+     */
+    void recordSegment(int worker, uint64_t candidates, uint64_t primes);
+
+    /**
+     * Sum all worker slots; safe to call from any thread while workers are running
+     */
+    Snapshot snapshot() const;
+
+private:
+    struct alignas(64) WorkerCounters {
+        std::atomic<uint64_t> candidates{0};
+        std::atomic<uint64_t> segments{0};
+        std::atomic<uint64_t> primes{0};
+    };
+
+    std::vector<WorkerCounters> workers;
+    std::atomic<uint64_t> totalCandidates{0};
+    std::atomic<uint64_t> totalSegments{0};
+};
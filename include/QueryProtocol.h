@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Query operations of the `--serve` daemon
+ * A request is a fixed 21-byte little-endian record: op (u8), id (u32), a (u64), b (u64)
+ */
+enum class QueryOp : uint8_t {
+    IS_PRIME = 1,   // a: number; answers 1 or 0
+    COUNT = 2,      // [a, b]: answers the number of primes
+    RANGE = 3,      // [a, b]: answers the primes themselves
+    NTH_PRIME = 4,  // a: 1-based index; answers the a-th prime
+    NEXT_PRIME = 5, // a: number; answers the smallest prime greater than a
+};
+
+enum class QueryStatus : uint8_t {
+    OK = 0,
+    BAD_REQUEST = 1,  // Unknown op or malformed arguments
+    OUT_OF_RANGE = 2, // Argument or answer beyond the cacheable range
+    TOO_LARGE = 3,    // RANGE answer would exceed the per-response limit
+};
+
+struct QueryRequest {
+    QueryOp op = QueryOp::IS_PRIME;
+    uint32_t id = 0; // Echoed in the response so pipelined clients can match answers
+    uint64_t a = 0;
+    uint64_t b = 0;
+};
+
+/**
+ * Response: id (u32), status (u8), value count (u32), then the values as u32
+ */
+struct QueryResponse {
+    uint32_t id = 0;
+    QueryStatus status = QueryStatus::OK;
+    std::vector<uint32_t> values;
+};
+
+class QueryProtocol {
+public:
+    static constexpr size_t REQUEST_SIZE = 21;
+    static constexpr size_t RESPONSE_HEADER_SIZE = 9;
+
+    static void encodeRequest(std::string &out, const QueryRequest &request);
+
+    /**
+     * Parse one request from exactly REQUEST_SIZE bytes; the op is not validated
+     */
+    static QueryRequest decodeRequest(std::string_view bytes);
+
+    static void encodeResponse(std::string &out, const QueryResponse &response);
+
+    /**
+     * Remove one complete response from the front of buffer; returns false when more bytes are needed
+     */
+    static bool takeResponse(std::string &buffer, QueryResponse &response);
+};
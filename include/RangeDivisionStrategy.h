@@ -8,6 +8,15 @@ private:
     static std::mutex consoleMutex;
 
 public:
-    std::vector<int> findPrimes(int upperLimit, int numThreads,
-                                std::shared_ptr<IPrintStrategy> printStrategy) override;
+    Task<PrimeSearchResult> findPrimesAsync(int upperLimit, int numThreads,
+                                            std::shared_ptr<IPrintStrategy> printStrategy,
+                                            SearchOptions options) override;
+
+    /**
+     * The same search with the sink type fixed at compile time, so primes are reported without
+     * virtual dispatch; instantiated for IPrintStrategy and the built-in print strategies
+     */
+    template <typename Sink>
+    Task<PrimeSearchResult> findPrimesWith(int upperLimit, int numThreads, std::shared_ptr<Sink> sink,
+                                           SearchOptions options);
 };
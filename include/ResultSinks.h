@@ -0,0 +1,101 @@
+#pragma once
+
+#include "IPrintStrategy.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Silent result sinks for library use
+ * Each keeps only what it needs, so a search streaming into them materializes nothing else
+ * (unless SearchOptions::collectPrimes asks for a copy in the result).
+ */
+
+/**
+ * Counts primes without storing them
+ */
+class CountSink : public IPrintStrategy {
+public:
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
+
+    /**
+     * Add a segment's count; makes this a CountingSink, so searches only build the primes when
+     * SearchOptions::collectPrimes is set
+     */
+    void addCount(size_t count, const SegmentInfo &info);
+
+    size_t count() const { return primeCount.load(); }
+
+private:
+    std::atomic<size_t> primeCount{0};
+};
+
+/**
+ * Collects primes into one vector, sorted by finalize
+ */
+class VectorSink : public IPrintStrategy {
+public:
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
+
+    const std::vector<int> &primes() const { return collected; }
+    std::vector<int> take() { return std::move(collected); }
+
+private:
+    std::mutex mutex;
+    std::vector<int> collected;
+};
+
+/**
+ * Writes one prime per line to a file, one write per segment; lines follow segment completion order
+ */
+class FileSink : public IPrintStrategy {
+public:
+    /**
+     * Throws std::runtime_error when the file cannot be opened
+     */
+    explicit FileSink(const std::string &path);
+
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
+
+private:
+    std::mutex mutex;
+    std::ofstream file;
+};
+
+/**
+ * Marks primes in a bitmap covering [0, upperLimit]: one bit per number instead of an int per prime
+ */
+class BitmapSink : public IPrintStrategy {
+public:
+    explicit BitmapSink(int upperLimit);
+
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
+
+    bool contains(int number) const;
+    size_t count() const;
+
+    /**
+     * Bit n of the bitmap (64 per word, low bit first) is set when n is prime
+     */
+    const std::vector<uint64_t> &words() const { return bits; }
+
+private:
+    void mark(int prime);
+
+    std::vector<uint64_t> bits;
+};
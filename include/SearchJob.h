@@ -0,0 +1,75 @@
+#pragma once
+
+#include "SearchOptions.h"
+#include "Task.h"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class IPrintStrategy;
+
+/**
+ * Bookkeeping for one asynchronous prime search running on the shared pool
+ * Collects committed segments, tracks stop state and fulfils the task when the last worker finishes
+ */
+class SearchJob {
+public:
+    SearchJob(std::shared_ptr<IPrintStrategy> printStrategy, SearchOptions options, int workers);
+
+    const SearchOptions &options() const { return searchOptions; }
+    const std::shared_ptr<IPrintStrategy> &printStrategy() const { return sink; }
+    Task<PrimeSearchResult> task() const { return promise.getTask(); }
+
+    /**
+     * Check the stop token and deadline, remembering that the run stopped early
+     */
+    bool shouldStop();
+
+    /**
+     * Flag the result as incomplete without a stop request, e.g. when a segment had to be abandoned
+     */
+    void markIncomplete() { wasStopped = true; }
+
+    /**
+     * Count a finished segment's primes as one unit and record progress for the worker
+     * The primes are kept for the result only when SearchOptions::collectPrimes is set.
+     */
+    void commitSegment(int worker, const Segment &segment, const std::vector<int> &primes);
+
+    /**
+     * Commit a segment known only by its prime count, for counting sinks
+     */
+    void commitCount(int worker, const Segment &segment, size_t count);
+
+    /**
+     * Record a worker failure; the first one is reported through the task
+     */
+    void fail(std::exception_ptr error);
+
+    /**
+     * Mark one worker as done; returns true for the last one, which must then call complete()
+     */
+    bool finishWorker();
+
+    bool stopped() const { return wasStopped; }
+    size_t primeCount();
+
+    /**
+     * Finalize the print strategy with the totals and fulfil the task
+     */
+    void complete();
+
+private:
+    std::shared_ptr<IPrintStrategy> sink;
+    SearchOptions searchOptions;
+    TaskPromise<PrimeSearchResult> promise;
+
+    std::mutex primesMutex;
+    std::vector<int> allPrimes; // Only filled when the options ask for the primes
+    size_t committedPrimes = 0;
+    std::exception_ptr firstError;
+    std::atomic<bool> wasStopped{false};
+    std::atomic<int> remainingWorkers;
+};
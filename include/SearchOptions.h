@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ProgressTracker.h"
+#include "Segment.h"
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+/**
+ * Per-run controls for a prime search
+ * Workers poll shouldStop() once per segment, so a stop takes effect within one segment
+ */
+struct SearchOptions {
+    std::stop_token stopToken;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    int segmentSize = SegmentPlanner::DEFAULT_SEGMENT_SIZE;
+    std::shared_ptr<ProgressTracker> progress; // Optional; updated once per finished segment
+    bool collectPrimes = false;                // Also fill PrimeSearchResult::primes; sinks see them anyway
+
+    bool shouldStop() const {
+        return stopToken.stop_requested() || (deadline && std::chrono::steady_clock::now() >= *deadline);
+    }
+};
+
+/**
+ * Primes found by a search
+ * When complete is false the run was cancelled or hit its deadline, and primes holds exactly
+ * the primes of the segments that finished before the stop. primes stays empty unless
+ * SearchOptions::collectPrimes is set; primeCount is always filled.
+ */
+struct PrimeSearchResult {
+    std::vector<int> primes;
+    bool complete = true;
+    size_t primeCount = 0;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * A contiguous block of candidates [start, end] processed as one unit of work
+ * Indices increase with start across the whole search, so segments can be ordered and reassembled
+ */
+struct Segment {
+    int index = 0;
+    int start = 0;
+    int end = 0;
+};
+
+class SegmentPlanner {
+public:
+    // Large enough to amortize bookkeeping, small enough to keep cancellation responsive.
+    static constexpr int DEFAULT_SEGMENT_SIZE = 32768;
+
+    /**
+     * Split [start, end] (inclusive) into segments of at most segmentSize candidates
+     * Segment indices are assigned consecutively starting at firstIndex
+     */
+    static std::vector<Segment> split(int start, int end, int segmentSize, int firstIndex = 0);
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+// Private to the division strategies that compile findPrimesWith<Sink>; not part of the public API.
+
+#include "BatchPrintStrategy.h"
+#include "BinaryPrintStrategy.h"
+#include "CountPrintStrategy.h"
+#include "EventClock.h"
+#include "FilePrintStrategy.h"
+#include "IPrintStrategy.h"
+#include "ImmediatePrintStrategy.h"
+#include "LivePrintStrategy.h"
+#include "OrderedPrintStrategy.h"
+#include "PrimeUtils.h"
+#include "ResultSinks.h"
+#include "SearchJob.h"
+#include "Segment.h"
+#include "ShardedPrintStrategy.h"
+#include "SinkPolicy.h"
+#include "StructuredPrintStrategy.h"
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+/**
+ * Every sink findPrimesWith is compiled for; PrimeFinder combinations must appear here
+ * Expand with a macro X(SinkType) to generate one explicit instantiation per sink.
+ */
+#define PRIME_FINDER_SINKS(X)                                                                                \
+    X(IPrintStrategy)                                                                                        \
+    X(ImmediatePrintStrategy)                                                                                \
+    X(BatchPrintStrategy)                                                                                    \
+    X(BinaryPrintStrategy)                                                                                   \
+    X(FilePrintStrategy)                                                                                     \
+    X(CountPrintStrategy)                                                                                    \
+    X(StructuredPrintStrategy)                                                                               \
+    X(OrderedPrintStrategy)                                                                                  \
+    X(LivePrintStrategy)                                                                                     \
+    X(ShardedPrintStrategy)                                                                                  \
+    X(CountSink)                                                                                             \
+    X(VectorSink)                                                                                            \
+    X(FileSink)                                                                                              \
+    X(BitmapSink)
+
+/**
+ * Process one claimed segment for a worker: wait for a windowed sink, restore a resumable one,
+ * count for a counting sink, otherwise find, deliver and commit the segment's primes
+ * Adds the segment's primes to threadPrimeCount. basePrimes and bits are only used by counting
+ * sinks. Returns false when the worker should stop instead of taking further segments.
+ */
+template <typename Sink>
+bool processSegment(SearchJob &job, Sink &sink, const Segment &segment, int worker,
+                    const std::vector<int> &basePrimes, std::vector<uint64_t> &bits,
+                    size_t &threadPrimeCount) {
+    // Ordered sinks hold finished segments; stay within their window.
+    if constexpr (WindowedSink<Sink>) {
+        if (!sink.awaitWindow(segment.index, [&job]() { return job.shouldStop(); })) {
+            return false;
+        }
+    }
+
+    // Resumable sinks hand back a segment an earlier run already wrote.
+    if constexpr (ResumableSink<Sink>) {
+        std::vector<int> restored;
+        if (sink.restoreShard(segment, restored)) {
+            job.commitSegment(worker, segment, restored);
+            threadPrimeCount += restored.size();
+            return true;
+        }
+    }
+
+    // Count-only sinks get a popcount of the sieved segment; no prime is materialized unless the
+    // caller asked for the primes in the result.
+    if constexpr (CountingSink<Sink>) {
+        if (!job.options().collectPrimes) {
+            int64_t end = static_cast<int64_t>(segment.end) + 1;
+            size_t count = PrimeUtils::countPrimesInSegment(segment.start, end, basePrimes, bits);
+            SegmentInfo info{segment, worker, std::this_thread::get_id(), EventClock::now()};
+            sink.addCount(count, info);
+            job.commitCount(worker, segment, count);
+            threadPrimeCount += count;
+            return true;
+        }
+    }
+
+    // Find all primes in this segment and report them in one call.
+    std::vector<int> segmentPrimes = PrimeUtils::findPrimesInRange(segment.start, segment.end);
+    SegmentInfo info{segment, worker, std::this_thread::get_id(), EventClock::now()};
+    deliverPrimes(sink, std::span<const int>(segmentPrimes), info);
+
+    // Add the whole segment to the global collection so partial results stay consistent.
+    job.commitSegment(worker, segment, segmentPrimes);
+    threadPrimeCount += segmentPrimes.size();
+    return true;
+}
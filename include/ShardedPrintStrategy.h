@@ -0,0 +1,107 @@
+#pragma once
+
+#include "IPrintStrategy.h"
+#include "OutputWriter.h"
+#include "Segment.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * How ShardedPrintStrategy stores the primes of a shard
+ */
+enum class ShardFormat {
+    TEXT, // One decimal prime per line
+    U32,  // Little-endian uint32 values, directly mappable
+};
+
+/**
+ * Writes every segment to its own file in a directory, plus a manifest describing them
+ * Workers write their shards in parallel as segments finish; nothing is funnelled through one
+ * file. manifest.tsv lists one shard per line in range order: file name, first and last candidate,
+ * prime count, size in bytes and CRC-32. It is rewritten at most every MANIFEST_INTERVAL while
+ * shards complete and once more by finalize, so a killed run keeps what it had finished. Range and
+ * queue searches ask restoreShard before computing a segment, so a rerun over the same segments
+ * reuses every shard whose file still matches its manifest entry and only computes the rest.
+ */
+class ShardedPrintStrategy : public IPrintStrategy {
+public:
+    static constexpr std::string_view MANIFEST_NAME = "manifest.tsv";
+    static constexpr std::chrono::milliseconds MANIFEST_INTERVAL{1000};
+
+    /**
+     * Create directory if needed and read an existing manifest; the summary goes to statusWriter, or
+     * standard output when null. Throws std::runtime_error when the directory cannot be created.
+     */
+    explicit ShardedPrintStrategy(const std::string &directory, ShardFormat format = ShardFormat::TEXT,
+                                  std::shared_ptr<IOutputWriter> statusWriter = nullptr);
+
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+
+    /**
+     * Write the segment's shard; throws std::runtime_error when it cannot be written
+     */
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+
+    /**
+     * Write the manifest and the summary line; throws std::runtime_error when the manifest fails
+     */
+    void finalize(const SearchSummary &summary) override;
+
+    /**
+     * Load the primes of segment from an earlier run's shard if its size and checksum still match
+     * Returns false, leaving primes empty, when the segment has to be computed.
+     */
+    bool restoreShard(const Segment &segment, std::vector<int> &primes);
+
+    size_t shardsReused() const { return reused.load(); }
+
+    /**
+     * Parse "text" or "u32"; throws std::invalid_argument otherwise
+     */
+    static ShardFormat parseFormat(const std::string &name);
+
+    /**
+     * CRC-32 (IEEE 802.3, as used by zlib and gzip)
+     */
+    static uint32_t crc32(std::string_view data);
+
+private:
+    struct ShardEntry {
+        std::string file;
+        int start = 0;
+        int end = 0;
+        size_t primes = 0;
+        size_t bytes = 0;
+        uint32_t crc = 0;
+    };
+
+    void record(ShardEntry entry);
+
+    /**
+     * Replace the manifest with entries, plus the earlier run's entries when keepPrevious is set
+     * Written to a temporary file, synced and renamed, so a crash leaves the old or the new manifest.
+     */
+    void writeManifest(std::vector<ShardEntry> shards, bool keepPrevious);
+
+    std::string directory;
+    ShardFormat format;
+    std::shared_ptr<IOutputWriter> writer;
+    std::map<std::pair<int, int>, ShardEntry> previous; // Manifest of an earlier run; read-only once loaded
+
+    std::mutex entriesMutex;
+    std::vector<ShardEntry> entries;
+    std::chrono::steady_clock::time_point lastManifest; // Guarded by entriesMutex
+    std::atomic<size_t> reused{0};
+
+    std::mutex manifestMutex;
+    size_t manifestShards = 0; // Entries in the newest manifest written; guarded by manifestMutex
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "IPrintStrategy.h"
+#include "Segment.h"
+#include <chrono>
+#include <concepts>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * A print strategy whose exact type is known at compile time
+ * Searches instantiated for such a sink call it directly instead of through the vtable.
+ */
+template <typename Sink>
+concept SinkPolicy = std::derived_from<Sink, IPrintStrategy> && !std::is_abstract_v<Sink>;
+
+/**
+ * A sink that only needs how many primes each segment holds
+ * Searches compiled for one sieve each segment and report its popcount, never enumerating primes
+ * unless SearchOptions::collectPrimes asks for them in the result.
+ */
+template <typename Sink>
+concept CountingSink = SinkPolicy<Sink> && requires(Sink &sink, size_t count, const SegmentInfo &info) {
+    sink.addCount(count, info);
+};
+
+/**
+ * A sink that emits segments in index order from a bounded reorder window
+ * Searches compiled for one call awaitWindow(segment index, stop predicate) before starting a
+ * segment, and stop when it returns false.
+ */
+template <typename Sink>
+concept WindowedSink =
+    SinkPolicy<Sink> && requires(Sink &sink, int index, const std::function<bool()> &shouldStop) {
+        { sink.awaitWindow(index, shouldStop) } -> std::convertible_to<bool>;
+    };
+
+/**
+ * A sink that may already hold a segment's primes from an earlier run
+ * Searches compiled for one call restoreShard(segment, primes) before computing a segment and skip the
+ * computation when it returns true, committing the restored primes instead.
+ */
+template <typename Sink>
+concept ResumableSink =
+    SinkPolicy<Sink> && requires(Sink &sink, const Segment &segment, std::vector<int> &primes) {
+        { sink.restoreShard(segment, primes) } -> std::convertible_to<bool>;
+    };
+
+/**
+ * Report one segment's primes; a qualified call for concrete sinks, a virtual call for IPrintStrategy
+ * Concrete sinks must be the object's dynamic type, which PrimeFinder guarantees by creating them.
+ */
+template <typename Sink>
+inline void deliverPrimes(Sink &sink, std::span<const int> primes, const SegmentInfo &info) {
+    if constexpr (std::is_abstract_v<Sink>) {
+        sink.printPrimes(primes, info);
+    } else {
+        sink.Sink::printPrimes(primes, info);
+    }
+}
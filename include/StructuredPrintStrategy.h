@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ConfigParser.h"
+#include "IPrintStrategy.h"
+#include "OutputWriter.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class StructuredFormat { NDJSON, CSV };
+
+/**
+ * Machine-readable output: one record per prime, then run summary records
+ * NDJSON prints {"type":"prime","worker":W,"value":P} per prime, then one "summary" object with the
+ * totals, timings, configuration and per-worker statistics. CSV has the header record,key,value:
+ * prime rows are prime,W,P and the summary follows as summary, config and worker rows.
+ * Records are formatted with to_chars into a reused per-thread buffer and written once per segment.
+ */
+class StructuredPrintStrategy : public IPrintStrategy {
+public:
+    StructuredPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter, StructuredFormat format,
+                            Config config = {});
+
+    void printPrime(int prime, std::thread::id threadId,
+                    std::chrono::system_clock::time_point timestamp) override;
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override;
+    void finalize(const SearchSummary &summary) override;
+
+private:
+    struct WorkerStats {
+        uint64_t primes = 0;
+        uint64_t segments = 0;
+        uint64_t candidates = 0;
+    };
+
+    std::string summaryRecords(const SearchSummary &summary, double elapsedMs) const;
+
+    std::shared_ptr<IOutputWriter> writer;
+    StructuredFormat format;
+    Config runConfig;
+    std::chrono::steady_clock::time_point started;
+    std::mutex statsMutex;
+    std::vector<WorkerStats> workers;
+};
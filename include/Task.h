@@ -0,0 +1,186 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+template <typename T> class Task;
+template <typename T> class TaskPromise;
+
+namespace detail {
+
+// Shared state between a TaskPromise and the Task handles observing it.
+template <typename T> struct TaskState {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::optional<T> value;
+    std::exception_ptr error;
+    bool done = false;
+    std::vector<std::function<void()>> continuations;
+
+    // Publish the outcome and release everything waiting on it.
+    void finish() {
+        std::vector<std::function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+            pending.swap(continuations);
+        }
+        ready.notify_all();
+        for (auto &continuation : pending) {
+            continuation();
+        }
+    }
+
+    // Run a callback once the state is done, immediately if it already is.
+    void onDone(std::function<void()> continuation) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!done) {
+                continuations.push_back(std::move(continuation));
+                return;
+            }
+        }
+        continuation();
+    }
+};
+
+// Continuations returning void produce a Task<std::monostate>.
+template <typename R> using TaskValue = std::conditional_t<std::is_void_v<R>, std::monostate, R>;
+
+} // namespace detail
+
+/**
+ * Write side of a Task
+ * Exactly one of setValue or setException must be called
+ */
+template <typename T> class TaskPromise {
+public:
+    TaskPromise() : state(std::make_shared<detail::TaskState<T>>()) {}
+
+    Task<T> getTask() const { return Task<T>(state); }
+
+    void setValue(T value) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->value.emplace(std::move(value));
+        }
+        state->finish();
+    }
+
+    void setException(std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->error = std::move(error);
+        }
+        state->finish();
+    }
+
+private:
+    std::shared_ptr<detail::TaskState<T>> state;
+};
+
+/**
+ * Shared handle to the result of asynchronous work
+ * Behaves like std::shared_future, plus then() for continuations on a ThreadPool and co_await support
+ */
+template <typename T> class Task {
+public:
+    Task() = default;
+
+    bool valid() const { return state != nullptr; }
+
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->done;
+    }
+
+    void wait() const {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->ready.wait(lock, [this]() { return state->done; });
+    }
+
+    template <typename Rep, typename Period> bool waitFor(std::chrono::duration<Rep, Period> timeout) const {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        return state->ready.wait_for(lock, timeout, [this]() { return state->done; });
+    }
+
+    /**
+     * Block until done, then return the value or rethrow the failure
+     */
+    const T &get() const {
+        wait();
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        return *state->value;
+    }
+
+    /**
+     * Block until done, then move the value out
+     * Only valid for the sole owner of the task, with no continuations attached
+     */
+    T take() {
+        wait();
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        return std::move(*state->value);
+    }
+
+    /**
+     * Run continuation(value) on the pool once this task succeeds
+     * A failure skips the continuation and is forwarded to the returned task
+     */
+    template <typename F>
+    auto then(F continuation, ThreadPool &pool = ThreadPool::shared())
+        -> Task<detail::TaskValue<std::invoke_result_t<F, const T &>>> {
+        using R = std::invoke_result_t<F, const T &>;
+        TaskPromise<detail::TaskValue<R>> next;
+        Task<detail::TaskValue<R>> result = next.getTask();
+
+        auto source = state;
+        state->onDone([source, next, continuation = std::move(continuation), &pool]() mutable {
+            pool.submit([source, next, continuation = std::move(continuation)]() mutable {
+                if (source->error) {
+                    next.setException(source->error);
+                    return;
+                }
+                try {
+                    if constexpr (std::is_void_v<R>) {
+                        continuation(*source->value);
+                        next.setValue(std::monostate{});
+                    } else {
+                        next.setValue(continuation(*source->value));
+                    }
+                } catch (...) {
+                    next.setException(std::current_exception());
+                }
+            });
+        });
+
+        return result;
+    }
+
+    // Awaiting a task from a coroutine resumes it on the shared pool once the task is done.
+    bool await_ready() const { return isReady(); }
+    void await_suspend(std::coroutine_handle<> handle) const {
+        state->onDone([handle]() { ThreadPool::shared().submit([handle]() { handle.resume(); }); });
+    }
+    const T &await_resume() const { return get(); }
+
+private:
+    friend class TaskPromise<T>;
+    explicit Task(std::shared_ptr<detail::TaskState<T>> sharedState) : state(std::move(sharedState)) {}
+
+    std::shared_ptr<detail::TaskState<T>> state;
+};
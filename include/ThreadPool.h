@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads shared by all prime searches
+ * Tasks run in FIFO order; the pool only grows, so concurrent jobs reuse the same workers
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t workers = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * Process-wide pool used by the division strategies
+     */
+    static ThreadPool &shared();
+
+    /**
+     * Grow the pool to at least the given number of workers
+     */
+    void ensureWorkers(size_t workers);
+
+    /**
+     * Queue a task to run on a worker thread
+     * Tasks must not throw and must not block waiting on other tasks of the same pool
+     */
+    void submit(std::function<void()> task);
+
+    size_t workerCount() const;
+
+private:
+    void workerLoop();
+
+    mutable std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+struct ThreadCountDecision {
+    int threads = 1;
+    std::string reason;
+};
+
+class ThreadUtils {
+public:
+    /**
+     * Pick a worker thread count for this process
+     * Combines the CPU affinity mask, the cgroup CPU quota and the SMT topology
+     */
+    static ThreadCountDecision detectThreadCount();
+
+    /**
+     * Parse a cgroup v2 cpu.max file ("<quota> <period>" or "max <period>")
+     * Returns the quota in CPUs, or nothing when unlimited or malformed
+     */
+    static std::optional<double> parseCgroupV2CpuMax(const std::string &contents);
+
+    /**
+     * Parse cgroup v1 cpu.cfs_quota_us and cpu.cfs_period_us contents
+     * Returns the quota in CPUs, or nothing when unlimited (-1) or malformed
+     */
+    static std::optional<double> parseCgroupV1Quota(const std::string &quota, const std::string &period);
+
+    /**
+     * Count the CPUs in a kernel CPU list such as "0-3,8,10-11"
+     * Returns 0 for an empty or malformed list
+     */
+    static int parseCpuListCount(const std::string &list);
+
+    /**
+     * Count the physical cores behind a set of CPUs, given each CPU's thread_siblings_list
+     * CPUs that share a list share a core; a CPU with an empty list counts as a core of its own.
+     */
+    static int countDistinctCores(const std::vector<std::string> &siblingLists);
+
+private:
+    static std::optional<double> readCgroupCpuQuota(std::string &source);
+    static std::vector<int> readAffinityCpus();
+    static int readCoreCount(const std::vector<int> &cpus);
+};
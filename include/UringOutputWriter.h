@@ -0,0 +1,75 @@
+#pragma once
+
+#include "OutputWriter.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * Writes through io_uring, keeping several large buffers in flight instead of blocking in write(2)
+ * Blocks are appended to the filling buffer; it is submitted when full or when no write is in flight,
+ * and the next free one takes over, so callers only wait when every buffer is still being written.
+ * Regular files get explicit offsets and up to queueDepth writes at once; pipes and terminals keep one
+ * write in flight so their bytes stay in order. Where io_uring is unavailable a helper thread does the
+ * same with pwrite(2).
+ */
+class UringOutputWriter : public IOutputWriter {
+public:
+    static constexpr size_t DEFAULT_BUFFER_BYTES = 1 << 20;
+    static constexpr unsigned DEFAULT_QUEUE_DEPTH = 4;
+
+    /**
+     * The descriptor is not owned; useUring = false forces the thread fallback
+     */
+    explicit UringOutputWriter(int fd, size_t bufferBytes = DEFAULT_BUFFER_BYTES,
+                               unsigned queueDepth = DEFAULT_QUEUE_DEPTH, bool useUring = true);
+    ~UringOutputWriter() override;
+
+    UringOutputWriter(const UringOutputWriter &) = delete;
+    UringOutputWriter &operator=(const UringOutputWriter &) = delete;
+
+    /**
+     * Create or truncate path and write to it; throws std::runtime_error when it cannot be opened
+     */
+    static std::shared_ptr<UringOutputWriter> openFile(const std::string &path);
+
+    /**
+     * Append a block; throws std::runtime_error once a submitted write has failed
+     */
+    void write(std::string_view lines) override;
+    void flush() override;
+
+    bool usingUring() const { return uring; }
+    uint64_t bytesWritten() const { return written.load(); }
+
+    /**
+     * Submits writes and reports which buffer finished; io_uring or a helper thread
+     */
+    class Backend;
+
+private:
+    void submitFilling();
+    bool reapOne(bool wait);
+
+    int fd;
+    bool ownsFd = false;
+    bool uring = false;
+    size_t bufferBytes;
+    unsigned maxInFlight;
+    off_t nextOffset = -1; // -1 when the descriptor cannot seek
+
+    std::mutex writeMutex;
+    std::vector<std::string> buffers; // maxInFlight in flight plus the one being filled
+    std::vector<size_t> freeBuffers;
+    size_t filling = 0;
+    unsigned inFlight = 0;
+    bool failed = false;
+    std::atomic<uint64_t> written{0};
+
+    std::unique_ptr<Backend> backend; // Declared last so in-flight writes finish before the buffers go
+};
@@ -0,0 +1,265 @@
+#include "AsyncOutputWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+// Chunks handed to one writev call.
+constexpr size_t WRITE_BATCH = 64;
+
+} // namespace
+
+// Set up the ring and start the writer thread.
+AsyncOutputWriter::AsyncOutputWriter(int outputFd, BackpressurePolicy backpressure, size_t capacity)
+    : fd(outputFd), policy(backpressure) {
+    size_t size = 1;
+    while (size < std::max<size_t>(capacity, 2)) {
+        size <<= 1;
+    }
+    mask = size - 1;
+    slots = std::make_unique<Slot[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    if (policy == BackpressurePolicy::SPILL) {
+        char path[] = "/tmp/prime_finder_spill_XXXXXX";
+        spillFd = mkstemp(path);
+        if (spillFd < 0) {
+            throw std::runtime_error("Cannot create output spill file");
+        }
+        unlink(path); // Removed from the directory now, freed on close.
+    }
+
+    writer = std::jthread([this](std::stop_token stop) { writerLoop(stop); });
+}
+
+// Drain everything, then stop the writer.
+AsyncOutputWriter::~AsyncOutputWriter() {
+    writer.request_stop();
+    pushed.fetch_add(1, std::memory_order_release);
+    pushed.notify_one();
+    writer.join();
+    if (spillFd >= 0) {
+        close(spillFd);
+    }
+}
+
+// Claim a slot with a CAS on the enqueue position (bounded MPMC ring, used with one consumer).
+bool AsyncOutputWriter::tryPush(std::string &chunk) {
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Slot &slot = slots[pos & mask];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.chunk = std::move(chunk);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // Full: the slot still holds a chunk from the previous lap.
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Take up to maxChunks published chunks in order.
+size_t AsyncOutputWriter::popBatch(std::string *chunks, size_t maxChunks) {
+    size_t count = 0;
+    while (count < maxChunks) {
+        Slot &slot = slots[dequeuePos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            break;
+        }
+        chunks[count++] = std::move(slot.chunk);
+        slot.chunk = std::string();
+        slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+    }
+    return count;
+}
+
+// Queue a chunk, applying the backpressure policy when the ring is full.
+void AsyncOutputWriter::write(std::string_view lines) {
+    if (failed) {
+        throw std::runtime_error("Failed to write output");
+    }
+    if (lines.empty()) {
+        return;
+    }
+
+    // Chunks go behind anything still waiting in the spill file, so lines never overtake each other.
+    if (policy == BackpressurePolicy::SPILL &&
+        spillRead.load(std::memory_order_acquire) < spillEnd.load(std::memory_order_acquire)) {
+        spill(lines);
+        return;
+    }
+
+    std::string chunk(lines);
+    while (!tryPush(chunk)) {
+        if (policy == BackpressurePolicy::DROP) {
+            dropped += static_cast<uint64_t>(std::count(lines.begin(), lines.end(), '\n'));
+            return;
+        }
+        if (policy == BackpressurePolicy::SPILL) {
+            spill(lines);
+            return;
+        }
+
+        // BLOCK: sleep until the writer frees slots, re-checking after reading the counter.
+        uint64_t seen = progress.load(std::memory_order_acquire);
+        if (tryPush(chunk)) {
+            break;
+        }
+        progress.wait(seen, std::memory_order_acquire);
+    }
+    pushed.fetch_add(1, std::memory_order_release);
+    pushed.notify_one();
+}
+
+// Append a chunk to the spill file for the writer to replay.
+void AsyncOutputWriter::spill(std::string_view lines) {
+    {
+        std::lock_guard<std::mutex> lock(spillMutex);
+        uint64_t offset = spillEnd.load();
+        while (!lines.empty()) {
+            ssize_t result = pwrite(spillFd, lines.data(), lines.size(), static_cast<off_t>(offset));
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                failed = true;
+                return;
+            }
+            lines.remove_prefix(static_cast<size_t>(result));
+            offset += static_cast<uint64_t>(result);
+        }
+        spillEnd.store(offset, std::memory_order_release);
+    }
+    pushed.fetch_add(1, std::memory_order_release);
+    pushed.notify_one();
+}
+
+// Copy spilled bytes to the descriptor; only whole chunks are ever below spillEnd.
+// Called when the ring is empty; chunks written meanwhile are spilled behind the ones being copied.
+bool AsyncOutputWriter::drainSpill() {
+    uint64_t end = spillEnd.load(std::memory_order_acquire);
+    uint64_t offset = spillRead.load(std::memory_order_relaxed);
+    if (offset >= end) {
+        return false;
+    }
+
+    std::string buffer(256 * 1024, '\0');
+    while (offset < end) {
+        size_t want = static_cast<size_t>(std::min<uint64_t>(buffer.size(), end - offset));
+        ssize_t result = pread(spillFd, buffer.data(), want, static_cast<off_t>(offset));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            failed = true;
+            break;
+        }
+        buffer.resize(static_cast<size_t>(result));
+        writeAll(&buffer, 1);
+        buffer.resize(256 * 1024);
+        offset += static_cast<uint64_t>(result);
+    }
+    spillRead.store(end, std::memory_order_release);
+    return true;
+}
+
+// writev a batch of chunks, continuing after partial writes.
+void AsyncOutputWriter::writeAll(std::string *chunks, size_t count) {
+    iovec vectors[WRITE_BATCH];
+    size_t first = 0;
+    size_t skip = 0; // Bytes of chunks[first] already written
+    while (first < count && !failed) {
+        size_t used = 0;
+        for (size_t i = first; i < count && used < WRITE_BATCH; ++i, ++used) {
+            size_t offset = i == first ? skip : 0;
+            vectors[used].iov_base = chunks[i].data() + offset;
+            vectors[used].iov_len = chunks[i].size() - offset;
+        }
+
+        ssize_t result = writev(fd, vectors, static_cast<int>(used));
+        if (result < 0) {
+            if (errno != EINTR) {
+                failed = true;
+            }
+            continue;
+        }
+
+        auto remaining = static_cast<size_t>(result);
+        while (first < count && remaining >= chunks[first].size() - skip) {
+            remaining -= chunks[first].size() - skip;
+            skip = 0;
+            ++first;
+        }
+        skip += remaining;
+    }
+}
+
+// Drain the ring and the spill file until stopped and empty.
+void AsyncOutputWriter::writerLoop(std::stop_token stop) {
+    std::string chunks[WRITE_BATCH];
+    while (true) {
+        uint64_t seen = pushed.load(std::memory_order_acquire);
+        size_t count = popBatch(chunks, WRITE_BATCH);
+        bool spilled = count == 0 && drainSpill();
+
+        if (count > 0) {
+            writeAll(chunks, count);
+            for (size_t i = 0; i < count; ++i) {
+                chunks[i] = std::string();
+            }
+            written.fetch_add(count, std::memory_order_release);
+        }
+        if (count > 0 || spilled) {
+            progress.fetch_add(1, std::memory_order_release);
+            progress.notify_all();
+            continue;
+        }
+
+        if (stop.stop_requested()) {
+            break;
+        }
+        pushed.wait(seen, std::memory_order_acquire);
+    }
+}
+
+// Wait until the writer has caught up with everything queued or spilled so far.
+void AsyncOutputWriter::flush() {
+    uint64_t targetChunks = enqueuePos.load(std::memory_order_acquire);
+    uint64_t targetSpill = spillEnd.load(std::memory_order_acquire);
+    while (true) {
+        uint64_t seen = progress.load(std::memory_order_acquire);
+        if ((written.load() >= targetChunks && spillRead.load() >= targetSpill) || !writer.joinable()) {
+            break;
+        }
+        progress.wait(seen, std::memory_order_acquire);
+    }
+    if (failed) {
+        throw std::runtime_error("Failed to write output");
+    }
+}
+
+// Parse a policy name from configuration.
+BackpressurePolicy AsyncOutputWriter::parsePolicy(const std::string &policy) {
+    if (policy == "block") {
+        return BackpressurePolicy::BLOCK;
+    } else if (policy == "drop") {
+        return BackpressurePolicy::DROP;
+    } else if (policy == "spill") {
+        return BackpressurePolicy::SPILL;
+    }
+    throw std::invalid_argument("Invalid output backpressure policy: " + policy);
+}
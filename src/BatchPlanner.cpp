@@ -0,0 +1,145 @@
+#include "BatchPlanner.h"
+#include "PrimeUtils.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <latch>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Parse a whole token as an int; trailing characters make it invalid.
+bool parseInt(const std::string &token, int &value) {
+    auto [next, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return error == std::errc() && next == token.data() + token.size();
+}
+
+} // namespace
+
+// Parse a job file.
+std::vector<BatchQuery> BatchPlanner::parse(std::istream &input) {
+    std::vector<BatchQuery> queries;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        std::istringstream fields(line);
+        std::string first;
+        if (!(fields >> first) || first[0] == '#') {
+            continue;
+        }
+
+        BatchQuery query;
+        std::string second;
+        fields >> second;
+        if (!parseInt(first, query.start) || !parseInt(second, query.end)) {
+            throw std::invalid_argument("Invalid batch query on line " + std::to_string(lineNumber) + ": " +
+                                        line);
+        }
+        fields >> query.output;
+        queries.push_back(std::move(query));
+    }
+
+    return queries;
+}
+
+// Merge overlapping query ranges and split the union into segments.
+BatchPlan BatchPlanner::plan(const std::vector<BatchQuery> &queries, int segmentSize) {
+    BatchPlan plan;
+    std::vector<std::pair<int, int>> ranges;
+    for (const BatchQuery &query : queries) {
+        if (query.start <= query.end) {
+            plan.requested += static_cast<long long>(query.end) - query.start + 1;
+        }
+        // Nothing below 2 is prime, so those candidates never need sieving.
+        int start = std::max(query.start, 2);
+        if (start <= query.end) {
+            ranges.emplace_back(start, query.end);
+        }
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    for (const auto &[start, end] : ranges) {
+        if (!plan.ranges.empty() && static_cast<long long>(start) <= plan.ranges.back().second + 1LL) {
+            plan.ranges.back().second = std::max(plan.ranges.back().second, end);
+        } else {
+            plan.ranges.emplace_back(start, end);
+        }
+    }
+
+    for (const auto &[start, end] : plan.ranges) {
+        int firstIndex = static_cast<int>(plan.segments.size());
+        auto segments = SegmentPlanner::split(start, end, segmentSize, firstIndex);
+        plan.segments.insert(plan.segments.end(), segments.begin(), segments.end());
+        plan.sieved += static_cast<long long>(end) - start + 1;
+    }
+
+    return plan;
+}
+
+// Sieve segments in parallel and concatenate their primes in segment order.
+std::vector<int> BatchPlanner::execute(const BatchPlan &plan, size_t numThreads) {
+    if (plan.segments.empty()) {
+        return {};
+    }
+
+    int maxEnd = plan.ranges.back().second;
+    std::vector<int> basePrimes = PrimeUtils::basePrimesFor(maxEnd);
+    std::vector<std::vector<int>> segmentPrimes(plan.segments.size());
+
+    ThreadPool &pool = ThreadPool::shared();
+    pool.ensureWorkers(numThreads);
+    std::latch done(static_cast<std::ptrdiff_t>(plan.segments.size()));
+    for (const Segment &segment : plan.segments) {
+        pool.submit([&segment, &basePrimes, &segmentPrimes, &done]() {
+            int64_t length = static_cast<int64_t>(segment.end) - segment.start + 1;
+            std::vector<uint64_t> bits(static_cast<size_t>((length + 63) / 64));
+            PrimeUtils::sieveSegment(segment.start, segment.start + length, basePrimes, bits.data());
+            PrimeUtils::appendSegmentPrimes(segment.start, length, bits.data(), segmentPrimes[segment.index]);
+            done.count_down();
+        });
+    }
+    done.wait();
+
+    std::vector<int> primes;
+    for (auto &segment : segmentPrimes) {
+        primes.insert(primes.end(), segment.begin(), segment.end());
+    }
+    return primes;
+}
+
+// Find a query's primes by binary search over the merged result.
+std::span<const int> BatchPlanner::primesFor(const std::vector<int> &primes, const BatchQuery &query) {
+    auto first = std::lower_bound(primes.begin(), primes.end(), query.start);
+    auto last = std::upper_bound(first, primes.end(), query.end);
+    return {first, last};
+}
+
+// Deliver every query's primes to its sink.
+void BatchPlanner::writeResults(const std::vector<BatchQuery> &queries, const std::vector<int> &primes,
+                                std::ostream &console) {
+    for (const BatchQuery &query : queries) {
+        std::span<const int> result = primesFor(primes, query);
+
+        if (!query.output.empty()) {
+            std::ofstream file(query.output);
+            if (!file) {
+                throw std::runtime_error("Cannot open batch output '" + query.output + "'");
+            }
+            for (int prime : result) {
+                file << prime << '\n';
+            }
+            continue;
+        }
+
+        console << "# [" << query.start << ", " << query.end << "] " << result.size() << " primes\n";
+        for (size_t i = 0; i < result.size(); ++i) {
+            console << (i == 0 ? "" : " ") << result[i];
+        }
+        console << '\n';
+    }
+    console.flush();
+}
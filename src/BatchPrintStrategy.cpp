@@ -1,6 +1,55 @@
 #include "BatchPrintStrategy.h"
 #include "ColorUtils.h"
 #include <algorithm>
+#include <charconv>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t PRIMES_PER_LINE = 10;
+constexpr size_t PRIMES_PER_BLOCK = 1 << 18;    // Formatted by one thread, written in one call
+constexpr size_t PARALLEL_THRESHOLD = 1 << 20; // Smaller results are formatted inline
+
+// Format primes[begin, end) as lines of ten; begin is a line boundary. Color codes wrap each line.
+std::string formatBlock(const std::vector<int> &primes, size_t begin, size_t end, std::string_view open,
+                        std::string_view close) {
+    size_t lines = (end - begin + PRIMES_PER_LINE - 1) / PRIMES_PER_LINE;
+    std::string out((end - begin) * 13 + lines * (open.size() + close.size() + 1), '\0');
+    char *cursor = out.data();
+    char *limit = out.data() + out.size();
+
+    for (size_t i = begin; i < end; ++i) {
+        bool lineStart = i % PRIMES_PER_LINE == 0;
+        bool lineEnd = (i + 1) % PRIMES_PER_LINE == 0 || i + 1 == primes.size();
+        if (lineStart) {
+            cursor = std::copy(open.begin(), open.end(), cursor);
+        }
+        cursor = std::to_chars(cursor, limit, primes[i]).ptr;
+        if (lineEnd) {
+            cursor = std::copy(close.begin(), close.end(), cursor);
+        }
+        if (i + 1 < primes.size()) {
+            *cursor++ = ',';
+            *cursor++ = ' ';
+        }
+        if ((i + 1) % PRIMES_PER_LINE == 0) {
+            *cursor++ = '\n';
+        }
+    }
+    out.resize(static_cast<size_t>(cursor - out.data()));
+    return out;
+}
+
+} // namespace
+
+// Print to standard output.
+BatchPrintStrategy::BatchPrintStrategy()
+    : BatchPrintStrategy(std::make_shared<FdOutputWriter>(STDOUT_FILENO)) {}
+
+// Print to the given writer.
+BatchPrintStrategy::BatchPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter)
+    : writer(std::move(outputWriter)) {}
 
 // Collect prime for batch printing.
 void BatchPrintStrategy::printPrime(int prime, std::thread::id /* threadId */,
@@ -10,24 +59,50 @@ void BatchPrintStrategy::printPrime(int prime, std::thread::id /* threadId */,
     // In batch mode, collect primes instead of printing immediately.
 }
 
-// Print all primes at once in sorted order.
-void BatchPrintStrategy::finalize(const std::vector<int> &allPrimes) {
-    std::cout << ColorUtils::info("[BATCH]") << " All threads completed. Found primes:" << std::endl;
+// Collect a whole segment under one lock.
+void BatchPrintStrategy::printPrimes(std::span<const int> primes, const SegmentInfo & /* info */) {
+    std::lock_guard<std::mutex> lock(collectionMutex);
+    collectedPrimes.insert(collectedPrimes.end(), primes.begin(), primes.end());
+}
+
+// Print all primes at once in sorted order, formatting blocks in parallel for large results.
+void BatchPrintStrategy::finalize(const SearchSummary & /* summary */) {
+    std::lock_guard<std::mutex> lock(collectionMutex);
+    writer->write(ColorUtils::info("[BATCH]") + " All threads completed. Found primes:\n");
+
+    // Sort the collected primes in place for consistent output.
+    std::sort(collectedPrimes.begin(), collectedPrimes.end());
 
-    // Sort the primes for consistent output.
-    std::vector<int> sortedPrimes = allPrimes;
-    std::sort(sortedPrimes.begin(), sortedPrimes.end());
+    std::string_view open = ColorUtils::primeColor();
+    std::string_view close = ColorUtils::resetColor();
+    size_t total = collectedPrimes.size();
+    size_t helpers = total < PARALLEL_THRESHOLD ? 1 : std::max(1u, std::thread::hardware_concurrency());
 
-    for (size_t i = 0; i < sortedPrimes.size(); ++i) {
-        std::cout << ColorUtils::prime(std::to_string(sortedPrimes[i]));
-        if (i < sortedPrimes.size() - 1) {
-            std::cout << ", ";
+    // Format a wave of blocks on helper threads (finalize may run on a pool worker, so not on the
+    // pool), then write them in order; memory stays bounded by one wave.
+    std::vector<std::string> blocks(helpers);
+    for (size_t waveStart = 0; waveStart < total; waveStart += helpers * PRIMES_PER_BLOCK) {
+        std::vector<std::jthread> formatters;
+        size_t used = 0;
+        for (; used < helpers && waveStart + used * PRIMES_PER_BLOCK < total; ++used) {
+            size_t begin = waveStart + used * PRIMES_PER_BLOCK;
+            size_t end = std::min(total, begin + PRIMES_PER_BLOCK);
+            auto format = [&, used, begin, end]() {
+                blocks[used] = formatBlock(collectedPrimes, begin, end, open, close);
+            };
+            if (helpers == 1) {
+                format();
+            } else {
+                formatters.emplace_back(format);
+            }
         }
-        if ((i + 1) % 10 == 0) {
-            std::cout << std::endl;
+        formatters.clear(); // Joins the helpers.
+
+        for (size_t i = 0; i < used; ++i) {
+            writer->write(blocks[i]);
         }
     }
-    std::cout << std::endl;
-    std::cout << ColorUtils::success("[BATCH] Total primes found: " + std::to_string(sortedPrimes.size()))
-              << std::endl;
+
+    writer->write("\n" + ColorUtils::success("[BATCH] Total primes found: " + std::to_string(total)) + "\n");
+    writer->flush();
 }
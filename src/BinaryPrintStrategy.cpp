@@ -0,0 +1,157 @@
+#include "BinaryPrintStrategy.h"
+#include "GapCodec.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Store value little-endian at out.
+template <typename T> void storeLittleEndian(char *out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+// Load a little-endian value from in.
+template <typename T> T loadLittleEndian(const char *in) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(static_cast<uint8_t>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+// Widen or reorder a segment into fixed-width little-endian values.
+template <typename T> void appendFixed(std::string &out, std::span<const int> primes) {
+    size_t offset = out.size();
+    out.resize(offset + primes.size() * sizeof(T));
+    for (int prime : primes) {
+        storeLittleEndian<T>(out.data() + offset, static_cast<T>(prime));
+        offset += sizeof(T);
+    }
+}
+
+} // namespace
+
+// Remember the encoding and write the stream header.
+BinaryPrintStrategy::BinaryPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter,
+                                         BinaryEncoding streamEncoding)
+    : writer(std::move(outputWriter)), encoding(streamEncoding) {
+    char header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC.data(), MAGIC.size());
+    header[4] = static_cast<char>(VERSION);
+    header[5] = static_cast<char>(encoding);
+    writer->write(std::string_view(header, HEADER_SIZE));
+    written += HEADER_SIZE;
+}
+
+// Write one prime as its own block.
+void BinaryPrintStrategy::printPrime(int prime, std::thread::id threadId,
+                                     std::chrono::system_clock::time_point timestamp) {
+    printPrimes(std::span<const int>(&prime, 1), SegmentInfo{{}, 0, threadId, timestamp});
+}
+
+// Encode a segment as one block. On little-endian hosts u32 blocks are written from the segment buffer.
+void BinaryPrintStrategy::printPrimes(std::span<const int> primes, const SegmentInfo & /* info */) {
+    if (primes.empty()) {
+        return;
+    }
+
+    thread_local std::string payload;
+    std::string_view body;
+    payload.clear();
+    if (encoding == BinaryEncoding::U32 && std::endian::native == std::endian::little) {
+        body = std::string_view(reinterpret_cast<const char *>(primes.data()), primes.size_bytes());
+    } else {
+        if (encoding == BinaryEncoding::U32) {
+            appendFixed<uint32_t>(payload, primes);
+        } else if (encoding == BinaryEncoding::U64) {
+            appendFixed<uint64_t>(payload, primes);
+        } else {
+            GapCodec::encodeGaps(payload, primes, 0);
+        }
+        body = payload;
+    }
+
+    char blockHeader[BLOCK_HEADER_SIZE];
+    storeLittleEndian<uint32_t>(blockHeader, static_cast<uint32_t>(primes.size()));
+    storeLittleEndian<uint32_t>(blockHeader + 4, static_cast<uint32_t>(body.size()));
+    std::string_view parts[] = {std::string_view(blockHeader, BLOCK_HEADER_SIZE), body};
+    writer->writeParts(parts);
+    written += BLOCK_HEADER_SIZE + body.size();
+}
+
+// Push everything to its destination.
+void BinaryPrintStrategy::finalize(const SearchSummary & /* summary */) { writer->flush(); }
+
+// Parse an encoding name.
+BinaryEncoding BinaryPrintStrategy::parseEncoding(const std::string &name) {
+    std::string lowerName = name;
+    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+
+    if (lowerName == "u32") {
+        return BinaryEncoding::U32;
+    } else if (lowerName == "u64") {
+        return BinaryEncoding::U64;
+    } else if (lowerName == "varint") {
+        return BinaryEncoding::VARINT;
+    } else {
+        throw std::invalid_argument("Invalid binary encoding: " + name);
+    }
+}
+
+// Validate the header, then decode blocks until the stream ends.
+std::vector<int> BinaryPrintStrategy::decode(std::string_view stream) {
+    if (stream.size() < HEADER_SIZE || stream.substr(0, MAGIC.size()) != MAGIC) {
+        throw std::invalid_argument("Not a binary prime stream");
+    }
+    if (static_cast<uint8_t>(stream[4]) != VERSION) {
+        throw std::invalid_argument("Unsupported binary stream version");
+    }
+    auto streamEncoding = static_cast<BinaryEncoding>(stream[5]);
+    if (streamEncoding != BinaryEncoding::U32 && streamEncoding != BinaryEncoding::U64 &&
+        streamEncoding != BinaryEncoding::VARINT) {
+        throw std::invalid_argument("Unknown binary encoding");
+    }
+
+    std::vector<int> primes;
+    size_t pos = HEADER_SIZE;
+    while (pos < stream.size()) {
+        if (stream.size() - pos < BLOCK_HEADER_SIZE) {
+            throw std::invalid_argument("Truncated block header");
+        }
+        uint32_t count = loadLittleEndian<uint32_t>(stream.data() + pos);
+        uint32_t size = loadLittleEndian<uint32_t>(stream.data() + pos + 4);
+        pos += BLOCK_HEADER_SIZE;
+        if (stream.size() - pos < size) {
+            throw std::invalid_argument("Truncated block");
+        }
+        std::string_view body = stream.substr(pos, size);
+        pos += size;
+
+        if (streamEncoding == BinaryEncoding::VARINT) {
+            size_t bodyPos = 0;
+            if (!GapCodec::decodeGaps(body, bodyPos, count, 0, primes) || bodyPos != body.size()) {
+                throw std::invalid_argument("Malformed varint block");
+            }
+            continue;
+        }
+
+        size_t width = streamEncoding == BinaryEncoding::U32 ? 4 : 8;
+        if (static_cast<uint64_t>(count) * width != size) {
+            throw std::invalid_argument("Block size does not match its count");
+        }
+        for (size_t offset = 0; offset < size; offset += width) {
+            uint64_t value = width == 4 ? loadLittleEndian<uint32_t>(body.data() + offset)
+                                        : loadLittleEndian<uint64_t>(body.data() + offset);
+            if (value > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+                throw std::invalid_argument("Prime out of range");
+            }
+            primes.push_back(static_cast<int>(value));
+        }
+    }
+    return primes;
+}
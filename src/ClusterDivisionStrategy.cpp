@@ -0,0 +1,279 @@
+#include "ClusterDivisionStrategy.h"
+#include "ClusterProtocol.h"
+#include "ColorUtils.h"
+#include "Console.h"
+#include "EventClock.h"
+#include "IPrintStrategy.h"
+#include "ResultSinks.h"
+#include "SearchJob.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <deque>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Define static mutex for console output protection.
+std::mutex ClusterDivisionStrategy::consoleMutex;
+
+namespace {
+
+enum class LeaseState { PENDING, LEASED, DONE };
+
+struct SegmentLease {
+    LeaseState state = LeaseState::PENDING;
+    int holder = -1; // Socket of the worker holding the current lease
+    std::chrono::steady_clock::time_point deadline;
+};
+
+struct WorkerConnection {
+    int fd = -1;
+    std::string inbox;
+    bool ready = false; // HELLO received
+    long lease = -1;    // Segment index currently leased to this worker
+};
+
+} // namespace
+
+// Store the coordinator settings.
+ClusterDivisionStrategy::ClusterDivisionStrategy(int port, std::chrono::milliseconds timeout)
+    : listenPort(port), leaseTimeout(timeout) {}
+
+// Open a listening TCP socket on all interfaces.
+int ClusterDivisionStrategy::openListener(int port, int &actualPort) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create coordinator socket");
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(fd, 64) < 0) {
+        close(fd);
+        throw std::runtime_error("Failed to listen on port " + std::to_string(port));
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length);
+    actualPort = ntohs(address.sin_port);
+    return fd;
+}
+
+// Start coordinating a cluster search on the shared pool.
+Task<PrimeSearchResult>
+ClusterDivisionStrategy::findPrimesAsync(int upperLimit, int /* numThreads */,
+                                         std::shared_ptr<IPrintStrategy> printStrategy,
+                                         SearchOptions options) {
+    int actualPort = 0;
+    int listener = openListener(listenPort, actualPort);
+    boundPort = actualPort;
+    {
+        std::lock_guard<std::mutex> lock(consoleMutex);
+        Console::status() << ColorUtils::highlight("[CLUSTER DIVISION]") << " Finding primes up to "
+                          << ColorUtils::bold(std::to_string(upperLimit)) << ", waiting for workers on port "
+                          << ColorUtils::bold(std::to_string(actualPort)) << std::endl;
+    }
+
+    auto job = std::make_shared<SearchJob>(std::move(printStrategy), std::move(options), 1);
+    ThreadPool &pool = ThreadPool::shared();
+    pool.ensureWorkers(1);
+
+    pool.submit([listener, upperLimit, timeout = leaseTimeout, job]() {
+        try {
+            coordinate(listener, upperLimit, timeout, *job);
+        } catch (...) {
+            job->fail(std::current_exception());
+        }
+        close(listener);
+
+        if (job->finishWorker()) {
+            if (job->stopped()) {
+                std::lock_guard<std::mutex> lock(consoleMutex);
+                Console::status() << ColorUtils::warning("[CLUSTER DIVISION] Stopped early")
+                                  << " - returning " << ColorUtils::bold(std::to_string(job->primeCount()))
+                                  << " primes from completed segments" << std::endl;
+            }
+            job->complete();
+        }
+    });
+
+    return job->task();
+}
+
+// Accept workers, hand out leases, collect results and re-dispatch expired leases.
+void ClusterDivisionStrategy::coordinate(int listener, int upperLimit, std::chrono::milliseconds leaseTimeout,
+                                         SearchJob &job) {
+    std::vector<Segment> segments = SegmentPlanner::split(2, upperLimit, job.options().segmentSize);
+    std::vector<SegmentLease> leases(segments.size());
+    std::deque<size_t> pending;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        pending.push_back(i);
+    }
+    if (job.options().progress) {
+        job.options().progress->setTotals(std::max(0, upperLimit - 1), segments.size());
+    }
+
+    std::vector<WorkerConnection> workers;
+    size_t doneCount = 0;
+
+    // A counting sink only needs each segment's count, so workers skip encoding primes for it.
+    auto *countSink = dynamic_cast<CountSink *>(job.printStrategy().get());
+    bool wantPrimes = !countSink || job.options().collectPrimes;
+
+    // Give idle workers the next pending segment.
+    auto dispatch = [&]() {
+        for (WorkerConnection &worker : workers) {
+            while (worker.ready && worker.lease < 0 && !pending.empty()) {
+                size_t index = pending.front();
+                pending.pop_front();
+                if (leases[index].state != LeaseState::PENDING) {
+                    continue; // Finished or re-leased since it was queued.
+                }
+
+                const Segment &segment = segments[index];
+                LeaseMessage lease{static_cast<uint32_t>(index), segment.start, segment.end, wantPrimes};
+                std::string frame =
+                    ClusterProtocol::frame(ClusterMessage::LEASE, ClusterProtocol::encodeLease(lease));
+                if (!ClusterProtocol::sendAll(worker.fd, frame)) {
+                    pending.push_front(index);
+                    break; // Connection is gone; it is dropped on the next poll.
+                }
+                auto deadline = std::chrono::steady_clock::now() + leaseTimeout;
+                leases[index] = {LeaseState::LEASED, worker.fd, deadline};
+                worker.lease = static_cast<long>(index);
+            }
+        }
+    };
+
+    // Drop a worker, returning its segment to the queue if it still holds the live lease.
+    auto disconnect = [&](WorkerConnection &worker) {
+        long index = worker.lease;
+        if (index >= 0 && leases[index].state == LeaseState::LEASED && leases[index].holder == worker.fd) {
+            leases[index].state = LeaseState::PENDING;
+            pending.push_front(static_cast<size_t>(index));
+        }
+        close(worker.fd);
+        worker.fd = -1;
+    };
+
+    // Accept the first valid result for a segment and report its primes; false for a malformed one.
+    auto handleResult = [&](WorkerConnection &worker, const std::string &payload) {
+        uint32_t index = 0;
+        ResultMessage result;
+        if (!ClusterProtocol::peekSegmentIndex(payload, index) || index >= segments.size() ||
+            !ClusterProtocol::decodeResult(payload, segments[index].start, result) ||
+            result.primes.size() != (wantPrimes ? result.count : 0)) {
+            return false;
+        }
+
+        const Segment &segment = segments[index];
+        if (result.count > static_cast<uint32_t>(segment.end - segment.start + 1)) {
+            return false;
+        }
+        for (int prime : result.primes) {
+            if (prime < segment.start || prime > segment.end) {
+                return false;
+            }
+        }
+
+        if (worker.lease == static_cast<long>(index)) {
+            worker.lease = -1;
+        }
+        if (leases[index].state == LeaseState::DONE) {
+            return true; // Duplicate from a straggler.
+        }
+
+        SegmentInfo info{segment, 0, std::this_thread::get_id(), EventClock::now()};
+        if (wantPrimes) {
+            job.printStrategy()->printPrimes(result.primes, info);
+            job.commitSegment(0, segment, result.primes);
+        } else {
+            countSink->addCount(result.count, info);
+            job.commitCount(0, segment, result.count);
+        }
+        leases[index].state = LeaseState::DONE;
+        ++doneCount;
+        return true;
+    };
+
+    while (doneCount < segments.size()) {
+        if (job.shouldStop()) {
+            break;
+        }
+
+        std::vector<pollfd> fds;
+        fds.push_back({listener, POLLIN, 0});
+        for (const WorkerConnection &worker : workers) {
+            fds.push_back({worker.fd, POLLIN, 0});
+        }
+        poll(fds.data(), fds.size(), 20);
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                workers.push_back({fd, {}, false, -1});
+            }
+        }
+
+        // Read from workers and drop the ones that disconnected.
+        for (size_t i = 1; i < fds.size(); ++i) {
+            WorkerConnection &worker = workers[i - 1];
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+
+            char buffer[65536];
+            ssize_t received = recv(worker.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (received <= 0) {
+                disconnect(worker);
+                continue;
+            }
+            worker.inbox.append(buffer, static_cast<size_t>(received));
+
+            try {
+                ClusterMessage type;
+                std::string payload;
+                while (ClusterProtocol::takeFrame(worker.inbox, type, payload)) {
+                    if (type == ClusterMessage::HELLO) {
+                        worker.ready = true;
+                    } else if (type != ClusterMessage::RESULT || !handleResult(worker, payload)) {
+                        throw std::runtime_error("unexpected message");
+                    }
+                }
+            } catch (const std::exception &e) {
+                std::lock_guard<std::mutex> lock(consoleMutex);
+                Console::status() << ColorUtils::warning("[CLUSTER DIVISION] Dropping worker") << " - "
+                                  << "protocol error: " << e.what() << std::endl;
+                disconnect(worker);
+            }
+        }
+        workers.erase(std::remove_if(workers.begin(), workers.end(),
+                                     [](const WorkerConnection &worker) { return worker.fd < 0; }),
+                      workers.end());
+
+        // Re-dispatch leases held by stragglers; whichever copy finishes first wins.
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < leases.size(); ++i) {
+            if (leases[i].state == LeaseState::LEASED && leases[i].deadline <= now) {
+                leases[i].state = LeaseState::PENDING;
+                pending.push_back(i);
+            }
+        }
+
+        dispatch();
+    }
+
+    for (WorkerConnection &worker : workers) {
+        ClusterProtocol::sendAll(worker.fd, ClusterProtocol::frame(ClusterMessage::DONE));
+        close(worker.fd);
+    }
+}
@@ -0,0 +1,173 @@
+#include "ClusterProtocol.h"
+#include "GapCodec.h"
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <sys/socket.h>
+
+namespace {
+
+// Append a little-endian uint32.
+void appendU32(std::string &out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// Read a little-endian uint32, advancing pos.
+bool readU32(std::string_view in, size_t &pos, uint32_t &value) {
+    if (pos > in.size() || in.size() - pos < 4) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(in[pos++])) << (8 * i);
+    }
+    return true;
+}
+
+} // namespace
+
+// Wrap a payload in a frame header.
+std::string ClusterProtocol::frame(ClusterMessage type, std::string_view payload) {
+    std::string out;
+    out.reserve(HEADER_SIZE + payload.size());
+    out.push_back(static_cast<char>(type));
+    appendU32(out, static_cast<uint32_t>(payload.size()));
+    out.append(payload);
+    return out;
+}
+
+// Serialize a lease.
+std::string ClusterProtocol::encodeLease(const LeaseMessage &lease) {
+    std::string out;
+    appendU32(out, lease.segmentIndex);
+    appendU32(out, static_cast<uint32_t>(lease.start));
+    appendU32(out, static_cast<uint32_t>(lease.end));
+    out.push_back(lease.wantPrimes ? 1 : 0);
+    return out;
+}
+
+// Parse a lease.
+bool ClusterProtocol::decodeLease(std::string_view payload, LeaseMessage &lease) {
+    size_t pos = 0;
+    uint32_t start = 0;
+    uint32_t end = 0;
+    if (!readU32(payload, pos, lease.segmentIndex) || !readU32(payload, pos, start) ||
+        !readU32(payload, pos, end) || pos >= payload.size()) {
+        return false;
+    }
+    lease.start = static_cast<int32_t>(start);
+    lease.end = static_cast<int32_t>(end);
+    lease.wantPrimes = payload[pos] != 0;
+    return lease.start <= lease.end;
+}
+
+// Serialize a result with gap-encoded primes.
+std::string ClusterProtocol::encodeResult(uint32_t segmentIndex, int segmentStart,
+                                          const std::vector<int> &primes, bool includePrimes) {
+    std::string out;
+    appendU32(out, segmentIndex);
+    appendU32(out, static_cast<uint32_t>(primes.size()));
+    if (includePrimes) {
+        GapCodec::encodeGaps(out, primes, static_cast<int64_t>(segmentStart) - 1);
+    }
+    return out;
+}
+
+// Serialize a result that carries only the prime count.
+std::string ClusterProtocol::encodeCount(uint32_t segmentIndex, uint32_t count) {
+    std::string out;
+    appendU32(out, segmentIndex);
+    appendU32(out, count);
+    return out;
+}
+
+// Parse a result; primes are present only if the payload carries them.
+bool ClusterProtocol::decodeResult(std::string_view payload, int segmentStart, ResultMessage &result) {
+    size_t pos = 0;
+    if (!readU32(payload, pos, result.segmentIndex) || !readU32(payload, pos, result.count)) {
+        return false;
+    }
+    result.primes.clear();
+    if (pos == payload.size()) {
+        return true;
+    }
+    return GapCodec::decodeGaps(payload, pos, result.count, static_cast<int64_t>(segmentStart) - 1,
+                                result.primes) &&
+           pos == payload.size();
+}
+
+// Read the leading segment index of a result.
+bool ClusterProtocol::peekSegmentIndex(std::string_view payload, uint32_t &segmentIndex) {
+    size_t pos = 0;
+    return readU32(payload, pos, segmentIndex);
+}
+
+// Split one frame off the front of a receive buffer.
+bool ClusterProtocol::takeFrame(std::string &buffer, ClusterMessage &type, std::string &payload) {
+    if (buffer.size() < HEADER_SIZE) {
+        return false;
+    }
+    size_t pos = 1;
+    uint32_t length = 0;
+    readU32(buffer, pos, length);
+    if (length > MAX_PAYLOAD) {
+        throw std::runtime_error("Cluster frame too large");
+    }
+    if (buffer.size() < HEADER_SIZE + length) {
+        return false;
+    }
+
+    type = static_cast<ClusterMessage>(buffer[0]);
+    payload.assign(buffer, HEADER_SIZE, length);
+    buffer.erase(0, HEADER_SIZE + length);
+    return true;
+}
+
+// Write the whole buffer, retrying short writes.
+bool ClusterProtocol::sendAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t written = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+    return true;
+}
+
+// Read exactly one frame, blocking.
+bool ClusterProtocol::receiveFrame(int fd, ClusterMessage &type, std::string &payload) {
+    std::string buffer;
+    char chunk[4096];
+    while (true) {
+        // Read no further than the current frame so nothing is lost between calls.
+        size_t wanted = HEADER_SIZE;
+        if (buffer.size() >= HEADER_SIZE) {
+            size_t pos = 1;
+            uint32_t length = 0;
+            readU32(buffer, pos, length);
+            if (length > MAX_PAYLOAD) {
+                return false;
+            }
+            wanted = HEADER_SIZE + length;
+        }
+        if (buffer.size() >= wanted && takeFrame(buffer, type, payload)) {
+            return true;
+        }
+
+        size_t toRead = std::min(sizeof(chunk), wanted - buffer.size());
+        ssize_t received = recv(fd, chunk, toRead, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        buffer.append(chunk, static_cast<size_t>(received));
+    }
+}
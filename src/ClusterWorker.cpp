@@ -0,0 +1,127 @@
+#include "ClusterWorker.h"
+#include "ClusterProtocol.h"
+#include "PrimeUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Parse "host:port".
+bool ClusterWorker::parseAddress(const std::string &address, std::string &host, int &port) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0) {
+        return false;
+    }
+    try {
+        size_t used = 0;
+        port = std::stoi(address.substr(colon + 1), &used);
+        if (used != address.size() - colon - 1 || port <= 0 || port > 65535) {
+            return false;
+        }
+    } catch (const std::exception &) {
+        return false;
+    }
+    host = address.substr(0, colon);
+    return true;
+}
+
+// Open a TCP connection to the coordinator.
+int ClusterWorker::connectTo(const std::string &host, int port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo *addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo *address = addresses; address != nullptr; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+    return fd;
+}
+
+// Process leases on one connection until the coordinator is done.
+long ClusterWorker::serveConnection(const std::string &host, int port) {
+    int fd = connectTo(host, port);
+    if (fd < 0) {
+        return -1;
+    }
+
+    // Base primes for every int, so any lease can be sieved without trial division.
+    static const std::vector<int> basePrimes = PrimeUtils::basePrimesFor(std::numeric_limits<int>::max());
+    std::vector<uint64_t> bits;
+    std::vector<int> primes;
+
+    long processed = 0;
+    ClusterProtocol::sendAll(fd, ClusterProtocol::frame(ClusterMessage::HELLO));
+
+    ClusterMessage type;
+    std::string payload;
+    while (ClusterProtocol::receiveFrame(fd, type, payload)) {
+        LeaseMessage lease;
+        if (type != ClusterMessage::LEASE || !ClusterProtocol::decodeLease(payload, lease)) {
+            break; // DONE, or something we do not understand.
+        }
+
+        int64_t end = static_cast<int64_t>(lease.end) + 1;
+        std::string result;
+        if (lease.wantPrimes) {
+            primes.clear();
+            if (lease.start < end) {
+                bits.resize(static_cast<size_t>((end - lease.start + 63) / 64));
+                PrimeUtils::sieveSegment(lease.start, end, basePrimes, bits.data());
+                PrimeUtils::appendSegmentPrimes(lease.start, end - lease.start, bits.data(), primes);
+            }
+            result = ClusterProtocol::encodeResult(lease.segmentIndex, lease.start, primes, true);
+        } else {
+            size_t count = PrimeUtils::countPrimesInSegment(lease.start, end, basePrimes, bits);
+            result = ClusterProtocol::encodeCount(lease.segmentIndex, static_cast<uint32_t>(count));
+        }
+        if (!ClusterProtocol::sendAll(fd, ClusterProtocol::frame(ClusterMessage::RESULT, result))) {
+            break;
+        }
+        ++processed;
+    }
+
+    close(fd);
+    return processed;
+}
+
+// Serve the coordinator over several parallel connections.
+long ClusterWorker::run(const std::string &host, int port, int connections) {
+    std::atomic<long> processed{0};
+    std::atomic<bool> connected{false};
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < std::max(1, connections); ++i) {
+        threads.emplace_back([&]() {
+            long count = serveConnection(host, port);
+            if (count >= 0) {
+                connected = true;
+                processed += count;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    return connected ? processed.load() : -1;
+}
@@ -1,80 +1,100 @@
 #include "ColorUtils.h"
+#include <array>
 #include <unistd.h>
 
-// Initialize static color enabled flag.
-bool ColorUtils::colorEnabled = true;
-
-// ANSI color code constants.
-const std::string ColorUtils::RESET = "\033[0m";
-const std::string ColorUtils::BOLD = "\033[1m";
-
-// Basic text colors.
-const std::string ColorUtils::RED = "\033[31m";
-const std::string ColorUtils::GREEN = "\033[32m";
-const std::string ColorUtils::YELLOW = "\033[33m";
-const std::string ColorUtils::BLUE = "\033[34m";
-const std::string ColorUtils::MAGENTA = "\033[35m";
-const std::string ColorUtils::CYAN = "\033[36m";
-const std::string ColorUtils::WHITE = "\033[37m";
-const std::string ColorUtils::GRAY = "\033[90m";
-
-// Background colors.
-const std::string ColorUtils::BG_RED = "\033[41m";
-const std::string ColorUtils::BG_GREEN = "\033[42m";
-const std::string ColorUtils::BG_YELLOW = "\033[43m";
-const std::string ColorUtils::BG_BLUE = "\033[44m";
-const std::string ColorUtils::BG_MAGENTA = "\033[45m";
-const std::string ColorUtils::BG_CYAN = "\033[46m";
-
-// Bright color variants.
-const std::string ColorUtils::BRIGHT_RED = "\033[91m";
-const std::string ColorUtils::BRIGHT_GREEN = "\033[92m";
-const std::string ColorUtils::BRIGHT_YELLOW = "\033[93m";
-const std::string ColorUtils::BRIGHT_BLUE = "\033[94m";
-const std::string ColorUtils::BRIGHT_MAGENTA = "\033[95m";
-const std::string ColorUtils::BRIGHT_CYAN = "\033[96m";
-const std::string ColorUtils::BRIGHT_WHITE = "\033[97m";
+namespace {
+
+// Opening escape sequence of each ColorUtils::Style, in declaration order.
+constexpr std::array<std::string_view, 9> STYLE_CODES = {
+    "\033[1m",         // BOLD
+    "\033[1m\033[91m", // ERROR: bold bright red
+    "\033[1m\033[92m", // SUCCESS: bold bright green
+    "\033[1m\033[93m", // WARNING: bold bright yellow
+    "\033[94m",        // INFO: bright blue
+    "\033[1m\033[96m", // HIGHLIGHT: bold bright cyan
+    "\033[1m\033[95m", // PRIME: bold bright magenta
+    "\033[96m",        // THREAD: bright cyan
+    "\033[90m",        // TIMESTAMP: gray
+};
+
+// Whether standard output is a terminal, checked on first use only.
+bool stdoutIsTerminal() {
+    static const bool terminal = isatty(STDOUT_FILENO);
+    return terminal;
+}
+
+// Wrap text in one style's codes, or copy it unchanged when colors are disabled.
+std::string styledString(std::string_view text, ColorUtils::Style style) {
+    std::string out;
+    ColorUtils::append(out, text, style);
+    return out;
+}
+
+} // namespace
+
+// Colors start enabled for terminals.
+bool ColorUtils::colorActive = stdoutIsTerminal();
 
 // Apply color to text if enabled.
-std::string ColorUtils::colorize(const std::string &text, const std::string &color) {
-    if (!isColorEnabled()) {
-        return text;
+std::string ColorUtils::colorize(std::string_view text, std::string_view color) {
+    if (!colorActive) {
+        return std::string(text);
     }
-    return color + text + RESET;
+    std::string out;
+    out.reserve(color.size() + text.size() + RESET.size());
+    out.append(color).append(text).append(RESET);
+    return out;
 }
 
 // Make text bold.
-std::string ColorUtils::bold(const std::string &text) { return colorize(text, BOLD); }
+std::string ColorUtils::bold(std::string_view text) { return styledString(text, Style::BOLD); }
 
 // Color text for error messages.
-std::string ColorUtils::error(const std::string &text) { return colorize(text, BOLD + BRIGHT_RED); }
+std::string ColorUtils::error(std::string_view text) { return styledString(text, Style::ERROR); }
 
 // Color text for success messages.
-std::string ColorUtils::success(const std::string &text) { return colorize(text, BOLD + BRIGHT_GREEN); }
+std::string ColorUtils::success(std::string_view text) { return styledString(text, Style::SUCCESS); }
 
 // Color text for warnings.
-std::string ColorUtils::warning(const std::string &text) { return colorize(text, BOLD + BRIGHT_YELLOW); }
+std::string ColorUtils::warning(std::string_view text) { return styledString(text, Style::WARNING); }
 
 // Color text for informational messages.
-std::string ColorUtils::info(const std::string &text) { return colorize(text, BRIGHT_BLUE); }
+std::string ColorUtils::info(std::string_view text) { return styledString(text, Style::INFO); }
 
 // Color text for highlights.
-std::string ColorUtils::highlight(const std::string &text) { return colorize(text, BOLD + BRIGHT_CYAN); }
+std::string ColorUtils::highlight(std::string_view text) { return styledString(text, Style::HIGHLIGHT); }
 
 // Color text for prime numbers.
-std::string ColorUtils::prime(const std::string &text) { return colorize(text, BOLD + BRIGHT_MAGENTA); }
+std::string ColorUtils::prime(std::string_view text) { return styledString(text, Style::PRIME); }
 
 // Color text for thread identifiers.
-std::string ColorUtils::thread(const std::string &text) { return colorize(text, BRIGHT_CYAN); }
+std::string ColorUtils::thread(std::string_view text) { return styledString(text, Style::THREAD); }
 
 // Color text for timestamps.
-std::string ColorUtils::timestamp(const std::string &text) { return colorize(text, GRAY); }
+std::string ColorUtils::timestamp(std::string_view text) { return styledString(text, Style::TIMESTAMP); }
 
-// Check if colors should be enabled.
-bool ColorUtils::isColorEnabled() {
-    // Check if output is a terminal and colors are enabled.
-    return colorEnabled && isatty(STDOUT_FILENO);
+// Append text wrapped in a style's codes.
+void ColorUtils::append(std::string &out, std::string_view text, Style style) {
+    if (!colorActive) {
+        out.append(text);
+        return;
+    }
+    out.append(STYLE_CODES[static_cast<size_t>(style)]).append(text).append(RESET);
 }
 
-// Set color enabled flag.
-void ColorUtils::setColorEnabled(bool enabled) { colorEnabled = enabled; }
+// Opening code of a style.
+std::string_view ColorUtils::code(Style style) {
+    return colorActive ? STYLE_CODES[static_cast<size_t>(style)] : std::string_view();
+}
+
+// Opening code for prime numbers.
+std::string_view ColorUtils::primeColor() { return code(Style::PRIME); }
+
+// Closing code for any color.
+std::string_view ColorUtils::resetColor() { return colorActive ? RESET : std::string_view(); }
+
+// Check if colors should be enabled.
+bool ColorUtils::isColorEnabled() { return colorActive; }
+
+// Set color enabled flag; colors still stay off when standard output is not a terminal.
+void ColorUtils::setColorEnabled(bool enabled) { colorActive = enabled && stdoutIsTerminal(); }
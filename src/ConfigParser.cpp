@@ -1,4 +1,5 @@
 #include "ConfigParser.h"
+#include "ThreadUtils.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -9,7 +10,7 @@ Config ConfigParser::parseConfig(const std::string &filename) {
 
     std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cout << "Config file '" << filename << "' not found. Using defaults." << std::endl;
+        std::cerr << "Config file '" << filename << "' not found. Using defaults." << std::endl;
         return config;
     }
 
@@ -39,13 +40,47 @@ Config ConfigParser::parseConfig(const std::string &filename) {
         // Set configuration values with error handling.
         try {
             if (key == "threads") {
-                config.threads = std::stoi(value);
+                if (value == "auto") {
+                    ThreadCountDecision decision = ThreadUtils::detectThreadCount();
+                    config.autoThreads = true;
+                    config.threads = decision.threads;
+                    config.threadsReason = decision.reason;
+                } else {
+                    config.autoThreads = false;
+                    config.threads = std::stoi(value);
+                }
             } else if (key == "upper_limit") {
                 config.upperLimit = std::stoi(value);
             } else if (key == "print_mode") {
                 config.printMode = value;
             } else if (key == "division_mode") {
                 config.divisionMode = value;
+            } else if (key == "progress_interval_ms") {
+                config.progressIntervalMs = std::stoi(value);
+            } else if (key == "progress_output") {
+                config.progressOutput = value;
+            } else if (key == "cluster_port") {
+                config.clusterPort = std::stoi(value);
+            } else if (key == "lease_timeout_ms") {
+                config.leaseTimeoutMs = std::stoi(value);
+            } else if (key == "output_backpressure") {
+                config.outputBackpressure = value;
+            } else if (key == "output_io") {
+                config.outputIo = value;
+            } else if (key == "output_file") {
+                config.outputFile = value;
+            } else if (key == "binary_encoding") {
+                config.binaryEncoding = value;
+            } else if (key == "reorder_window") {
+                config.reorderWindow = std::stoi(value);
+            } else if (key == "frame_rate") {
+                config.frameRate = std::stoi(value);
+            } else if (key == "shard_dir") {
+                config.shardDir = value;
+            } else if (key == "shard_format") {
+                config.shardFormat = value;
+            } else if (key == "cache_limit") {
+                config.cacheLimit = std::stoi(value);
             }
         } catch (const std::exception &e) {
             std::cerr << "Error parsing config value for '" << key << "': " << e.what() << std::endl;
@@ -0,0 +1,30 @@
+#include "Console.h"
+#include <streambuf>
+
+namespace {
+
+// Accepts every character and keeps none, so a muted stream never enters a failed state.
+class DiscardBuffer : public std::streambuf {
+protected:
+    int overflow(int ch) override { return traits_type::not_eof(ch); }
+    std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+};
+
+} // namespace
+
+bool Console::toStderr = false;
+bool Console::muted = false;
+
+// Pick the stream for status messages.
+std::ostream &Console::status() {
+    static DiscardBuffer buffer;
+    static std::ostream discard(&buffer);
+    if (muted) {
+        return discard;
+    }
+    return toStderr ? std::cerr : std::cout;
+}
+
+void Console::setStatusToStderr(bool enabled) { toStderr = enabled; }
+
+void Console::setStatusMuted(bool enabled) { muted = enabled; }
@@ -0,0 +1,27 @@
+#include "CountPrintStrategy.h"
+#include "ColorUtils.h"
+#include <string>
+#include <unistd.h>
+
+// Print to standard output.
+CountPrintStrategy::CountPrintStrategy()
+    : CountPrintStrategy(std::make_shared<FdOutputWriter>(STDOUT_FILENO)) {}
+
+// Print to the given writer; the clock starts now, when the search is set up.
+CountPrintStrategy::CountPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter)
+    : writer(std::move(outputWriter)), started(std::chrono::steady_clock::now()) {}
+
+// Report the total and the elapsed time.
+void CountPrintStrategy::finalize(const SearchSummary &summary) {
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started);
+    std::string milliseconds = std::to_string(elapsed.count());
+    milliseconds.resize(milliseconds.find('.') + 3);
+
+    std::string line = ColorUtils::info("[COUNT]") + " Total primes found: " +
+                       ColorUtils::bold(std::to_string(summary.primeCount)) + " in " + milliseconds + " ms";
+    if (!summary.complete) {
+        line += " " + ColorUtils::warning("(stopped early)");
+    }
+    writer->write(line + "\n");
+    writer->flush();
+}
@@ -0,0 +1,65 @@
+#include "EventClock.h"
+#include <charconv>
+#include <format>
+
+namespace {
+
+// Steady and wall-clock readings taken together when the program starts.
+struct Anchor {
+    std::chrono::steady_clock::time_point steady = std::chrono::steady_clock::now();
+    std::chrono::system_clock::time_point system = std::chrono::system_clock::now();
+};
+
+const Anchor &anchor() {
+    static const Anchor start;
+    return start;
+}
+
+// Taken during static initialization, so elapsed times count from program start.
+[[maybe_unused]] const Anchor &startup = anchor();
+
+// Calendar text of the last second this thread rendered.
+struct SecondCache {
+    std::chrono::sys_seconds second{std::chrono::seconds::min()};
+    std::string text;
+};
+
+} // namespace
+
+// Map the steady clock onto wall-clock time.
+EventClock::TimePoint EventClock::now() {
+    auto elapsed = std::chrono::steady_clock::now() - anchor().steady;
+    return anchor().system + std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed);
+}
+
+// Time since the anchor.
+std::chrono::nanoseconds EventClock::sinceStart(TimePoint timestamp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp - anchor().system);
+}
+
+// Format the calendar text only when the second changes.
+void EventClock::appendWallClock(std::string &out, TimePoint timestamp) {
+    thread_local SecondCache cache;
+    auto second = std::chrono::floor<std::chrono::seconds>(timestamp);
+    if (second != cache.second) {
+        cache.second = second;
+        cache.text = std::format("{:%a %b %d %H:%M:%S %Y}", second);
+    }
+    out += cache.text;
+}
+
+// Seconds and zero-padded nanoseconds, without going through a stream.
+void EventClock::appendElapsed(std::string &out, TimePoint timestamp) {
+    long long nanos = sinceStart(timestamp).count();
+    if (nanos < 0) {
+        nanos = 0;
+    }
+    char digits[24];
+    out += '+';
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), nanos / 1'000'000'000).ptr);
+    out += '.';
+    char *end = std::to_chars(digits, digits + sizeof(digits), nanos % 1'000'000'000).ptr;
+    out.append(9 - (end - digits), '0');
+    out.append(digits, end);
+    out += 's';
+}
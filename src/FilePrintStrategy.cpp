@@ -0,0 +1,125 @@
+#include "FilePrintStrategy.h"
+#include "ColorUtils.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Open the output file.
+FilePrintStrategy::FilePrintStrategy(const std::string &outputPath,
+                                     std::shared_ptr<IOutputWriter> statusWriter)
+    : path(outputPath), writer(std::move(statusWriter)) {
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open output file '" + path + "'");
+    }
+    if (!writer) {
+        writer = std::make_shared<FdOutputWriter>(STDOUT_FILENO);
+    }
+}
+
+FilePrintStrategy::~FilePrintStrategy() { ::close(fd); }
+
+// Format one prime and claim the next bytes of the file for it.
+void FilePrintStrategy::printPrime(int prime, std::thread::id /* threadId */,
+                                   std::chrono::system_clock::time_point /* timestamp */) {
+    std::vector<std::string> run{std::to_string(prime) + "\n"};
+    off_t offset;
+    {
+        std::lock_guard<std::mutex> lock(placeMutex);
+        offset = placedBytes;
+        placedBytes += static_cast<off_t>(run[0].size());
+    }
+    writeRun(run, offset);
+}
+
+// Format the segment on the calling thread; only placing it takes the lock, never the write.
+void FilePrintStrategy::printPrimes(std::span<const int> primes, const SegmentInfo &info) {
+    std::string text(primes.size() * 11, '\0');
+    char *out = text.data();
+    for (int prime : primes) {
+        out = std::to_chars(out, text.data() + text.size(), prime).ptr;
+        *out++ = '\n';
+    }
+    text.resize(static_cast<size_t>(out - text.data()));
+
+    // Empty segments are placed too, so the ones after them are not held forever.
+    std::vector<std::string> run;
+    off_t offset;
+    {
+        std::lock_guard<std::mutex> lock(placeMutex);
+        if (info.segment.index != nextIndex) {
+            held.emplace(info.segment.index, std::move(text));
+            return;
+        }
+        offset = placedBytes;
+        run.push_back(std::move(text));
+        ++nextIndex;
+        for (auto next = held.find(nextIndex); next != held.end(); next = held.find(++nextIndex)) {
+            run.push_back(std::move(next->second));
+            held.erase(next);
+        }
+        for (const std::string &chunk : run) {
+            placedBytes += static_cast<off_t>(chunk.size());
+        }
+    }
+    writeRun(run, offset);
+}
+
+// Write the run back to back starting at offset, many chunks per system call.
+void FilePrintStrategy::writeRun(const std::vector<std::string> &run, off_t offset) const {
+    std::vector<iovec> pending;
+    for (const std::string &chunk : run) {
+        if (!chunk.empty()) {
+            pending.push_back(iovec{const_cast<char *>(chunk.data()), chunk.size()});
+        }
+    }
+
+    size_t first = 0;
+    while (first < pending.size()) {
+        int count = static_cast<int>(std::min<size_t>(pending.size() - first, IOV_MAX));
+        ssize_t result = ::pwritev(fd, pending.data() + first, count, offset);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write output file '" + path + "'");
+        }
+        offset += result;
+        size_t remaining = static_cast<size_t>(result);
+        while (first < pending.size() && remaining >= pending[first].iov_len) {
+            remaining -= pending[first].iov_len;
+            ++first;
+        }
+        if (remaining > 0) {
+            pending[first].iov_base = static_cast<char *>(pending[first].iov_base) + remaining;
+            pending[first].iov_len -= remaining;
+        }
+    }
+}
+
+// Place what a stopped search left behind in index order, then report the total.
+void FilePrintStrategy::finalize(const SearchSummary &summary) {
+    std::vector<std::string> run;
+    off_t offset;
+    off_t total;
+    {
+        std::lock_guard<std::mutex> lock(placeMutex);
+        offset = placedBytes;
+        for (auto &[index, text] : held) {
+            placedBytes += static_cast<off_t>(text.size());
+            run.push_back(std::move(text));
+        }
+        held.clear();
+        total = placedBytes;
+    }
+    writeRun(run, offset);
+
+    writer->write(ColorUtils::info("[FILE]") + " Wrote " + std::to_string(summary.primeCount) +
+                  " primes (" + std::to_string(total) + " bytes) to " + path + "\n");
+    writer->flush();
+}
@@ -0,0 +1,54 @@
+#include "GapCodec.h"
+#include <limits>
+
+// Append value seven bits at a time, low bits first.
+void GapCodec::appendVarint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Read a varint written by appendVarint.
+bool GapCodec::readVarint(std::string_view in, size_t &pos, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) {
+            return false;
+        }
+        uint8_t byte = static_cast<uint8_t>(in[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Encode primes as gaps from the previous value.
+void GapCodec::encodeGaps(std::string &out, std::span<const int> primes, int64_t base) {
+    int64_t previous = base;
+    for (int prime : primes) {
+        appendVarint(out, static_cast<uint64_t>(prime - previous));
+        previous = prime;
+    }
+}
+
+// Decode gaps back into absolute values.
+bool GapCodec::decodeGaps(std::string_view in, size_t &pos, size_t count, int64_t base,
+                          std::vector<int> &primes) {
+    int64_t previous = base;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t gap = 0;
+        if (!readVarint(in, pos, gap) || gap > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            return false;
+        }
+        previous += static_cast<int64_t>(gap);
+        if (previous > std::numeric_limits<int>::max()) {
+            return false;
+        }
+        primes.push_back(static_cast<int>(previous));
+    }
+    return true;
+}
@@ -1,28 +1,144 @@
 #include "ImmediatePrintStrategy.h"
 #include "ColorUtils.h"
-#include <format>
+#include "EventClock.h"
+#include <charconv>
+#include <condition_variable>
 #include <sstream>
+#include <unistd.h>
 
-// Print prime immediately with thread info and timestamp.
-void ImmediatePrintStrategy::printPrime(int prime, std::thread::id /* threadId */,
+// Format the shared parts of a line once per batch.
+void ImmediatePrintStrategy::formatLines(std::string &out, std::span<const int> primes,
+                                         std::thread::id threadId,
+                                         std::chrono::system_clock::time_point timestamp) {
+    std::string time;
+    EventClock::appendWallClock(time, timestamp);
+    time += " (";
+    EventClock::appendElapsed(time, timestamp);
+    time += ')';
+    std::stringstream ss;
+    ss << threadId;
+    std::string prefix;
+    ColorUtils::append(prefix, "[IMMEDIATE]", ColorUtils::Style::INFO);
+    prefix += " Thread ";
+    ColorUtils::append(prefix, ss.str(), ColorUtils::Style::THREAD);
+    prefix += " found prime: ";
+    // The stamp is taken once per segment, so the line says so rather than implying a per-prime time.
+    std::string suffix = " in segment done at ";
+    ColorUtils::append(suffix, time, ColorUtils::Style::TIMESTAMP);
+    suffix += '\n';
+    std::string_view open = ColorUtils::primeColor();
+    std::string_view close = ColorUtils::resetColor();
+
+    char digits[16];
+    for (int prime : primes) {
+        out += prefix;
+        out += open;
+        out.append(digits, std::to_chars(digits, digits + sizeof(digits), prime).ptr);
+        out += close;
+        out += suffix;
+    }
+}
+
+// Print to standard output.
+ImmediatePrintStrategy::ImmediatePrintStrategy()
+    : ImmediatePrintStrategy(std::make_shared<FdOutputWriter>(STDOUT_FILENO)) {}
+
+// Print to the given writer.
+ImmediatePrintStrategy::ImmediatePrintStrategy(std::shared_ptr<IOutputWriter> outputWriter, size_t bytes,
+                                               std::chrono::milliseconds interval)
+    : writer(std::move(outputWriter)), flushBytes(bytes), flushInterval(interval) {}
+
+// Stop the flusher and write whatever is still buffered.
+ImmediatePrintStrategy::~ImmediatePrintStrategy() {
+    if (flusher.joinable()) {
+        flusher.request_stop();
+        flusher.join();
+    }
+    try {
+        flushAll(false);
+    } catch (...) {
+        // Nothing sensible to do about a failed write during destruction.
+    }
+}
+
+// Find or create the calling thread's buffer.
+ImmediatePrintStrategy::ThreadBuffer &ImmediatePrintStrategy::bufferFor(std::thread::id threadId) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    auto &buffer = buffers[threadId];
+    if (!buffer) {
+        buffer = std::make_unique<ThreadBuffer>();
+    }
+    return *buffer;
+}
+
+// Hand a buffer's lines to the writer; the caller holds the buffer's lock.
+void ImmediatePrintStrategy::flushBuffer(ThreadBuffer &buffer) {
+    if (!buffer.lines.empty()) {
+        writer->write(buffer.lines);
+        buffer.lines.clear();
+    }
+    buffer.lastFlush = std::chrono::steady_clock::now();
+}
+
+// Flush every buffer, or only those that have waited longer than the interval.
+void ImmediatePrintStrategy::flushAll(bool onlyStale) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    auto now = std::chrono::steady_clock::now();
+    for (auto &[threadId, buffer] : buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (!onlyStale || now - buffer->lastFlush >= flushInterval) {
+            flushBuffer(*buffer);
+        }
+    }
+}
+
+// Start the background flusher that bounds how long a line can sit in a buffer.
+void ImmediatePrintStrategy::startFlusher() {
+    std::call_once(flusherStarted, [this]() {
+        flusher = std::jthread([this](std::stop_token stop) {
+            std::mutex sleepMutex;
+            std::condition_variable_any wakeup;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            while (!wakeup.wait_for(lock, stop, flushInterval, [] { return false; })) {
+                if (stop.stop_requested()) {
+                    break;
+                }
+                try {
+                    flushAll(true);
+                } catch (...) {
+                    // Write errors surface from the next foreground flush.
+                }
+            }
+        });
+    });
+}
+
+// Print one prime through the calling thread's buffer.
+void ImmediatePrintStrategy::printPrime(int prime, std::thread::id threadId,
                                         std::chrono::system_clock::time_point timestamp) {
-    std::lock_guard<std::mutex> lock(printMutex);
+    printPrimes(std::span<const int>(&prime, 1), SegmentInfo{{}, 0, threadId, timestamp});
+}
 
-    // Convert timestamp to readable format.
-    auto time_t = std::chrono::system_clock::to_time_t(timestamp);
-    std::stringstream ss;
-    ss << std::this_thread::get_id();
+// Append a whole segment to the thread's buffer and flush it once it is large or old enough.
+void ImmediatePrintStrategy::printPrimes(std::span<const int> primes, const SegmentInfo &info) {
+    if (primes.empty()) {
+        return;
+    }
+    startFlusher();
 
-    std::cout << ColorUtils::info("[IMMEDIATE]") << " Thread " << ColorUtils::thread(ss.str())
-              << " found prime: " << ColorUtils::prime(std::to_string(prime)) << " at "
-              << ColorUtils::timestamp(
-                     std::format("{:%a %b %d %H:%M:%S %Y}", std::chrono::system_clock::from_time_t(time_t)))
-              << std::endl;
+    ThreadBuffer &buffer = bufferFor(info.threadId);
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    formatLines(buffer.lines, primes, info.threadId, info.timestamp);
+    auto waited = std::chrono::steady_clock::now() - buffer.lastFlush;
+    if (buffer.lines.size() >= flushBytes || waited >= flushInterval) {
+        flushBuffer(buffer);
+    }
 }
 
-// Print final summary with total count.
-void ImmediatePrintStrategy::finalize(const std::vector<int> &allPrimes) {
-    std::lock_guard<std::mutex> lock(printMutex);
-    std::cout << ColorUtils::success("[IMMEDIATE] Total primes found: " + std::to_string(allPrimes.size()))
-              << std::endl;
+// Flush all buffered lines, then print the summary.
+void ImmediatePrintStrategy::finalize(const SearchSummary &summary) {
+    flushAll(false);
+    std::string total = std::to_string(summary.primeCount);
+    writer->write(ColorUtils::success("[IMMEDIATE] Total primes found: " + total) + "\n");
+    writer->flush();
 }
@@ -0,0 +1,190 @@
+#include "IntervalQueryEngine.h"
+#include "PrimeUtils.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <bit>
+#include <latch>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Part of one query's answer found in one segment.
+struct Contribution {
+    size_t query;
+    uint64_t count;
+    std::vector<int> primes;
+};
+
+// Sweep a contiguous run of segments in ascending order, answering the queries that intersect them.
+void sweep(const std::vector<IntervalQuery> &queries, const std::vector<size_t> &byStart,
+           const std::vector<int64_t> &segments, int64_t segmentSize, const std::vector<int> &basePrimes,
+           std::vector<Contribution> &contributions) {
+    int64_t words = segmentSize / 64;
+    std::vector<uint64_t> bits(static_cast<size_t>(words));
+    std::vector<uint32_t> prefix(static_cast<size_t>(words) + 1);
+
+    // Queries already open when the run begins come from a binary search over starts.
+    int64_t runStart = segments.front() * segmentSize;
+    auto firstAfter = std::upper_bound(byStart.begin(), byStart.end(), runStart,
+                                       [&](int64_t value, size_t q) { return value < queries[q].start; });
+    size_t next = static_cast<size_t>(firstAfter - byStart.begin());
+    std::vector<size_t> active;
+    for (size_t i = 0; i < next; ++i) {
+        if (queries[byStart[i]].end >= runStart) {
+            active.push_back(byStart[i]);
+        }
+    }
+
+    for (int64_t segment : segments) {
+        int64_t segStart = segment * segmentSize;
+        int64_t segEnd = segStart + segmentSize - 1;
+
+        // Admit queries starting in this segment, retire those that ended before it.
+        while (next < byStart.size() && queries[byStart[next]].start <= segEnd) {
+            active.push_back(byStart[next++]);
+        }
+        std::erase_if(active, [&](size_t q) { return queries[q].end < segStart; });
+        if (active.empty()) {
+            continue;
+        }
+
+        PrimeUtils::sieveSegment(segStart, segEnd + 1, basePrimes, bits.data());
+        for (int64_t word = 0; word < words; ++word) {
+            prefix[word + 1] = prefix[word] + std::popcount(bits[word]);
+        }
+        // Primes at offsets [0, offset) of this segment.
+        auto below = [&](int64_t offset) -> uint64_t {
+            if (offset >= segmentSize) {
+                return prefix[words];
+            }
+            uint64_t mask = (uint64_t{1} << (offset % 64)) - 1;
+            return prefix[offset / 64] + std::popcount(bits[offset / 64] & mask);
+        };
+
+        for (size_t q : active) {
+            int64_t low = std::max<int64_t>(queries[q].start, segStart) - segStart;
+            int64_t high = std::min<int64_t>(queries[q].end, segEnd) - segStart;
+            Contribution contribution{q, below(high + 1) - below(low), {}};
+            if (queries[q].listPrimes && contribution.count > 0) {
+                for (int64_t offset = low; offset <= high; ++offset) {
+                    if ((bits[offset / 64] >> (offset % 64)) & 1) {
+                        contribution.primes.push_back(static_cast<int>(segStart + offset));
+                    }
+                }
+            }
+            if (contribution.count > 0) {
+                contributions.push_back(std::move(contribution));
+            }
+        }
+    }
+}
+
+} // namespace
+
+// Plan the sweep, run one run of segments per thread, then merge contributions in segment order.
+std::vector<IntervalAnswer> IntervalQueryEngine::answer(const std::vector<IntervalQuery> &queries,
+                                                        int numThreads, int segmentSize) {
+    std::vector<IntervalAnswer> answers(queries.size());
+    int64_t size = std::max<int64_t>(64, segmentSize / 64 * 64);
+
+    // Only valid queries take part; nothing below 2 is prime.
+    std::vector<size_t> byStart;
+    for (size_t q = 0; q < queries.size(); ++q) {
+        if (queries[q].start <= queries[q].end && queries[q].end >= 2) {
+            byStart.push_back(q);
+        }
+    }
+    if (byStart.empty()) {
+        return answers;
+    }
+    std::sort(byStart.begin(), byStart.end(), [&](size_t a, size_t b) {
+        return queries[a].start < queries[b].start;
+    });
+
+    // Segments touched by at least one query, in ascending order.
+    std::vector<int64_t> segments;
+    int maxEnd = 0;
+    for (size_t q : byStart) {
+        int64_t first = std::max(queries[q].start, 0) / size;
+        int64_t last = queries[q].end / size;
+        first = segments.empty() ? first : std::max(first, segments.back() + 1);
+        for (int64_t segment = first; segment <= last; ++segment) {
+            segments.push_back(segment);
+        }
+        maxEnd = std::max(maxEnd, queries[q].end);
+    }
+    int64_t sievedEnd = (maxEnd / size + 1) * size;
+    std::vector<int> basePrimes = PrimeUtils::basePrimesFor(
+        static_cast<int>(std::min<int64_t>(sievedEnd - 1, std::numeric_limits<int>::max())));
+
+    // One contiguous run of segments per thread keeps each sweep ascending.
+    size_t runs = std::min(segments.size(), static_cast<size_t>(std::max(1, numThreads)));
+    std::vector<std::vector<Contribution>> contributions(runs);
+    ThreadPool &pool = ThreadPool::shared();
+    pool.ensureWorkers(runs);
+    std::latch done(static_cast<std::ptrdiff_t>(runs));
+    for (size_t run = 0; run < runs; ++run) {
+        size_t first = segments.size() * run / runs;
+        size_t last = segments.size() * (run + 1) / runs;
+        pool.submit([&, run, first, last]() {
+            std::vector<int64_t> runSegments(segments.begin() + first, segments.begin() + last);
+            sweep(queries, byStart, runSegments, size, basePrimes, contributions[run]);
+            done.count_down();
+        });
+    }
+    done.wait();
+
+    for (auto &runContributions : contributions) {
+        for (Contribution &contribution : runContributions) {
+            IntervalAnswer &answer = answers[contribution.query];
+            answer.count += contribution.count;
+            auto &primes = contribution.primes;
+            answer.primes.insert(answer.primes.end(), primes.begin(), primes.end());
+        }
+    }
+    return answers;
+}
+
+// Parse a query file.
+std::vector<IntervalQuery> IntervalQueryEngine::parse(std::istream &input) {
+    std::vector<IntervalQuery> queries;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        std::istringstream fields(line);
+        std::string kind;
+        if (!(fields >> kind) || kind[0] == '#') {
+            continue;
+        }
+
+        IntervalQuery query;
+        query.listPrimes = kind == "list";
+        if ((kind != "count" && kind != "list") || !(fields >> query.start >> query.end)) {
+            std::string where = "line " + std::to_string(lineNumber);
+            throw std::invalid_argument("Invalid interval query on " + where + ": " + line);
+        }
+        queries.push_back(query);
+    }
+
+    return queries;
+}
+
+// Write answers in query order.
+void IntervalQueryEngine::write(const std::vector<IntervalQuery> &queries,
+                                const std::vector<IntervalAnswer> &answers, std::ostream &output) {
+    for (size_t q = 0; q < queries.size(); ++q) {
+        output << answers[q].count;
+        if (queries[q].listPrimes) {
+            for (int prime : answers[q].primes) {
+                output << ' ' << prime;
+            }
+        }
+        output << '\n';
+    }
+    output.flush();
+}
@@ -0,0 +1,144 @@
+#include "LivePrintStrategy.h"
+#include "ColorUtils.h"
+#include <algorithm>
+#include <condition_variable>
+#include <unistd.h>
+
+// Draw to standard output.
+LivePrintStrategy::LivePrintStrategy() : LivePrintStrategy(std::make_shared<FdOutputWriter>(STDOUT_FILENO)) {}
+
+// Draw to the given writer, optionally passing every prime on to fullResults.
+LivePrintStrategy::LivePrintStrategy(std::shared_ptr<IOutputWriter> outputWriter,
+                                     std::shared_ptr<IPrintStrategy> fullResults, int frameRate)
+    : writer(std::move(outputWriter)), fullResults(std::move(fullResults)),
+      frameInterval(std::chrono::milliseconds(1000 / std::clamp(frameRate, 1, 1000))),
+      redraw(isatty(STDOUT_FILENO)), started(std::chrono::steady_clock::now()) {}
+
+// Stop the renderer before the state it reads goes away.
+LivePrintStrategy::~LivePrintStrategy() {
+    if (renderer.joinable()) {
+        renderer.request_stop();
+        renderer.join();
+    }
+}
+
+// Count one prime; it reaches the full results as a lone prime, outside the segment order.
+void LivePrintStrategy::printPrime(int prime, std::thread::id threadId,
+                                   std::chrono::system_clock::time_point timestamp) {
+    startRenderer();
+    if (fullResults) {
+        fullResults->printPrime(prime, threadId, timestamp);
+    }
+    countPrimes(std::span<const int>(&prime, 1));
+}
+
+// Pass the segment on to the full results and count it.
+void LivePrintStrategy::printPrimes(std::span<const int> primes, const SegmentInfo &info) {
+    startRenderer();
+    if (fullResults) {
+        fullResults->printPrimes(primes, info);
+    }
+    countPrimes(primes);
+}
+
+// Update the counters and the recent primes; skip the latter rather than wait for the lock.
+void LivePrintStrategy::countPrimes(std::span<const int> primes) {
+    if (primes.empty()) {
+        return;
+    }
+
+    primeCount.fetch_add(primes.size(), std::memory_order_relaxed);
+    int segmentLargest = primes.back();
+    int current = largest.load(std::memory_order_relaxed);
+    while (segmentLargest > current && !largest.compare_exchange_weak(current, segmentLargest)) {
+    }
+
+    std::unique_lock<std::mutex> lock(recentMutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        for (int prime : primes.last(std::min(primes.size(), RECENT_PRIMES))) {
+            recent[recentCount++ % RECENT_PRIMES] = prime;
+        }
+    }
+}
+
+// Stop drawing, hand the full results over, then draw the final frame and the total.
+void LivePrintStrategy::finalize(const SearchSummary &summary) {
+    if (renderer.joinable()) {
+        renderer.request_stop();
+        renderer.join();
+    }
+    lastDrawnCount = UINT64_MAX;
+    drawFrame();
+    if (redraw) {
+        writer->write("\n");
+    }
+    writer->flush();
+
+    if (fullResults) {
+        fullResults->finalize(summary);
+    }
+    std::string total = std::to_string(summary.primeCount);
+    std::string line = ColorUtils::success("[LIVE] Total primes found: " + total);
+    if (!summary.complete) {
+        line += " " + ColorUtils::warning("(stopped early)");
+    }
+    writer->write(line + "\n");
+    writer->flush();
+}
+
+// One status line: totals, rate, the largest prime and the most recent ones.
+std::string LivePrintStrategy::renderFrame() {
+    uint64_t count = primeCount.load(std::memory_order_relaxed);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    uint64_t rate = seconds > 0 ? static_cast<uint64_t>(count / seconds) : 0;
+
+    std::string frame;
+    ColorUtils::append(frame, "[LIVE]", ColorUtils::Style::INFO);
+    frame += " " + std::to_string(count) + " primes, " + std::to_string(rate) + "/s, largest ";
+    std::string largestPrime = std::to_string(largest.load(std::memory_order_relaxed));
+    ColorUtils::append(frame, largestPrime, ColorUtils::Style::PRIME);
+
+    std::lock_guard<std::mutex> lock(recentMutex);
+    size_t shown = std::min(recentCount, RECENT_PRIMES);
+    if (shown > 0) {
+        frame += ", recent:";
+        for (size_t i = recentCount - shown; i < recentCount; ++i) {
+            frame += " " + std::to_string(recent[i % RECENT_PRIMES]);
+        }
+    }
+    return frame;
+}
+
+// Draw a frame if anything changed since the last one.
+void LivePrintStrategy::drawFrame() {
+    uint64_t count = primeCount.load(std::memory_order_relaxed);
+    if (count == lastDrawnCount) {
+        return;
+    }
+    lastDrawnCount = count;
+    std::string frame = renderFrame();
+    writer->write(redraw ? "\r\033[K" + frame : frame + "\n");
+    frames.fetch_add(1);
+}
+
+// Start the thread that draws a frame every frame interval.
+void LivePrintStrategy::startRenderer() {
+    std::call_once(rendererStarted, [this]() {
+        renderer = std::jthread([this](std::stop_token stop) {
+            std::mutex sleepMutex;
+            std::condition_variable_any wakeup;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            while (!wakeup.wait_for(lock, stop, frameInterval, [] { return false; })) {
+                if (stop.stop_requested()) {
+                    break;
+                }
+                try {
+                    drawFrame();
+                    writer->flush();
+                } catch (...) {
+                    // A failed frame is dropped; finalize reports write errors.
+                }
+            }
+        });
+    });
+}
@@ -0,0 +1,88 @@
+#include "OrderedPrintStrategy.h"
+#include "ColorUtils.h"
+#include "ImmediatePrintStrategy.h"
+#include <algorithm>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::chrono::milliseconds STOP_POLL_INTERVAL{10}; // How often a waiting producer checks for a stop
+
+} // namespace
+
+// Print to standard output.
+OrderedPrintStrategy::OrderedPrintStrategy()
+    : OrderedPrintStrategy(std::make_shared<FdOutputWriter>(STDOUT_FILENO)) {}
+
+// Print to the given writer with a window of the given number of segments.
+OrderedPrintStrategy::OrderedPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter, int windowSegments)
+    : writer(std::move(outputWriter)), window(std::max(1, windowSegments)) {}
+
+// Write a lone prime immediately; it has no place in the segment order.
+void OrderedPrintStrategy::printPrime(int prime, std::thread::id threadId,
+                                      std::chrono::system_clock::time_point timestamp) {
+    std::string lines;
+    ImmediatePrintStrategy::formatLines(lines, std::span<const int>(&prime, 1), threadId, timestamp);
+    writer->write(lines);
+}
+
+// Format outside the lock, then write this segment and every held one that now follows in order.
+void OrderedPrintStrategy::printPrimes(std::span<const int> primes, const SegmentInfo &info) {
+    std::string lines;
+    ImmediatePrintStrategy::formatLines(lines, primes, info.threadId, info.timestamp);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (info.segment.index != nextIndex) {
+        held[info.segment.index] = std::move(lines);
+        peakHeld = std::max(peakHeld, held.size());
+        return;
+    }
+
+    // Writing under the lock keeps the blocks in order; the formatting already happened in parallel.
+    std::string ready = std::move(lines);
+    ++nextIndex;
+    for (auto it = held.begin(); it != held.end() && it->first == nextIndex; it = held.erase(it)) {
+        ready += it->second;
+        ++nextIndex;
+    }
+    if (!ready.empty()) {
+        writer->write(ready);
+    }
+    advanced.notify_all();
+}
+
+// Write whatever is still held, in order; gaps remain where a stopped search skipped segments.
+void OrderedPrintStrategy::finalize(const SearchSummary &summary) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string rest;
+    for (auto &[index, lines] : held) {
+        rest += lines;
+    }
+    held.clear();
+    if (!rest.empty()) {
+        writer->write(rest);
+    }
+    std::string total = std::to_string(summary.primeCount);
+    writer->write(ColorUtils::success("[ORDERED] Total primes found: " + total) + "\n");
+    writer->flush();
+}
+
+// Wait for the segments before the window to be written, checking for a stop between naps.
+bool OrderedPrintStrategy::awaitWindow(int segmentIndex, const std::function<bool()> &shouldStop) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (segmentIndex >= nextIndex + window) {
+        lock.unlock();
+        if (shouldStop()) {
+            return false;
+        }
+        lock.lock();
+        advanced.wait_for(lock, STOP_POLL_INTERVAL, [&] { return segmentIndex < nextIndex + window; });
+    }
+    return true;
+}
+
+// Report the high-water mark of held segments.
+size_t OrderedPrintStrategy::peakHeldSegments() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return peakHeld;
+}
@@ -0,0 +1,80 @@
+#include "OutputWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+// Wrap a descriptor.
+FdOutputWriter::FdOutputWriter(int outputFd) : fd(outputFd) {}
+
+// Close the descriptor if this writer opened it.
+FdOutputWriter::~FdOutputWriter() {
+    if (ownsFd) {
+        ::close(fd);
+    }
+}
+
+// Open a file for writing and hand its descriptor to a new writer.
+std::shared_ptr<FdOutputWriter> FdOutputWriter::openFile(const std::string &path) {
+    int fileFd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileFd < 0) {
+        throw std::runtime_error("Cannot open output file '" + path + "'");
+    }
+    auto writer = std::make_shared<FdOutputWriter>(fileFd);
+    writer->ownsFd = true;
+    return writer;
+}
+
+// Write the whole block under the lock so concurrent blocks stay contiguous.
+void FdOutputWriter::write(std::string_view lines) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    while (!lines.empty()) {
+        ssize_t result = ::write(fd, lines.data(), lines.size());
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write output");
+        }
+        lines.remove_prefix(static_cast<size_t>(result));
+        written += static_cast<uint64_t>(result);
+    }
+}
+
+// Gather the pieces with writev(2), resuming after partial writes.
+void FdOutputWriter::writeParts(std::span<const std::string_view> parts) {
+    std::vector<iovec> pending;
+    pending.reserve(parts.size());
+    for (std::string_view part : parts) {
+        if (!part.empty()) {
+            pending.push_back(iovec{const_cast<char *>(part.data()), part.size()});
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    size_t first = 0;
+    while (first < pending.size()) {
+        int count = static_cast<int>(std::min<size_t>(pending.size() - first, IOV_MAX));
+        ssize_t result = ::writev(fd, pending.data() + first, count);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write output");
+        }
+        written += static_cast<uint64_t>(result);
+        size_t remaining = static_cast<size_t>(result);
+        while (first < pending.size() && remaining >= pending[first].iov_len) {
+            remaining -= pending[first].iov_len;
+            ++first;
+        }
+        if (remaining > 0) {
+            pending[first].iov_base = static_cast<char *>(pending[first].iov_base) + remaining;
+            pending[first].iov_len -= remaining;
+        }
+    }
+}
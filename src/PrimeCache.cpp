@@ -0,0 +1,147 @@
+#include "PrimeCache.h"
+#include "PrimeUtils.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <latch>
+
+// Create an empty cache that sieves on the given pool and never grows past ceiling.
+PrimeCache::PrimeCache(ThreadPool &threadPool, int64_t ceiling)
+    : pool(threadPool), maxCached(std::clamp<int64_t>(ceiling, 0, MAX_LIMIT)) {}
+
+// Grow the bitmap to cover n, sieving the new chunks in parallel.
+void PrimeCache::ensure(int64_t n) {
+    n = std::min(n, maxCached);
+    if (n <= limit()) {
+        return;
+    }
+
+    // Grow at least geometrically so repeated small extensions stay cheap; whole words up to the ceiling.
+    int64_t oldEnd = static_cast<int64_t>(bits.size()) * 64;
+    int64_t newEnd = std::max({n + 1, 2 * oldEnd, CHUNK_SIZE});
+    newEnd = std::min((newEnd + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE, (maxCached + 64) / 64 * 64);
+
+    int sievedLast = static_cast<int>(std::min(newEnd - 1, MAX_LIMIT));
+    std::vector<int> basePrimes = PrimeUtils::basePrimesFor(sievedLast);
+    size_t oldWords = bits.size();
+    bits.resize(static_cast<size_t>(newEnd / 64));
+
+    // Chunks are word-aligned, so each task writes its own words.
+    int64_t chunks = (newEnd - oldEnd + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::latch done(chunks);
+    for (int64_t chunkStart = oldEnd; chunkStart < newEnd; chunkStart += CHUNK_SIZE) {
+        pool.submit([this, chunkStart, newEnd, &basePrimes, &done]() {
+            int64_t chunkEnd = std::min(newEnd, chunkStart + CHUNK_SIZE);
+            PrimeUtils::sieveSegment(chunkStart, chunkEnd, basePrimes, bits.data() + chunkStart / 64);
+            done.count_down();
+        });
+    }
+    done.wait();
+
+    // Extend the prefix counts over the new words.
+    wordPrefix.resize(bits.size());
+    for (size_t word = oldWords; word < bits.size(); ++word) {
+        wordPrefix[word] = word == 0 ? 0 : wordPrefix[word - 1] + std::popcount(bits[word - 1]);
+    }
+}
+
+// Count primes below n using the prefix table and one popcount.
+uint32_t PrimeCache::primesBelow(int64_t n) const {
+    if (n <= 0) {
+        return 0;
+    }
+    size_t word = static_cast<size_t>(n / 64);
+    if (word >= bits.size()) {
+        return wordPrefix.back() + std::popcount(bits.back());
+    }
+    uint64_t mask = (uint64_t{1} << (n % 64)) - 1;
+    return wordPrefix[word] + std::popcount(bits[word] & mask);
+}
+
+// Test one number.
+bool PrimeCache::isPrime(int n) {
+    if (n < 2) {
+        return false;
+    }
+    ensure(n);
+    return (bits[n / 64] >> (n % 64)) & 1;
+}
+
+// Count primes in an inclusive range.
+uint32_t PrimeCache::count(int low, int high) {
+    if (high < 2 || low > high) {
+        return 0;
+    }
+    ensure(high);
+    return primesBelow(static_cast<int64_t>(high) + 1) - primesBelow(std::max(low, 0));
+}
+
+// List primes in an inclusive range, bounded by maxPrimes.
+bool PrimeCache::collect(int low, int high, size_t maxPrimes, std::vector<uint32_t> &out) {
+    if (count(low, high) > maxPrimes) {
+        return false;
+    }
+    if (high < 2 || low > high) {
+        return true;
+    }
+
+    int64_t first = std::max(low, 2);
+    int64_t last = high;
+    for (int64_t word = first / 64; word <= last / 64; ++word) {
+        uint64_t value = bits[word];
+        if (word == first / 64) {
+            value &= ~uint64_t{0} << (first % 64);
+        }
+        if (word == last / 64 && last % 64 != 63) {
+            value &= (uint64_t{1} << (last % 64 + 1)) - 1;
+        }
+        for (; value != 0; value &= value - 1) {
+            out.push_back(static_cast<uint32_t>(word * 64 + std::countr_zero(value)));
+        }
+    }
+    return true;
+}
+
+// Find the k-th prime by growing the cache to an upper bound and searching the prefix table.
+std::optional<int> PrimeCache::nthPrime(uint32_t k) {
+    if (k == 0) {
+        return std::nullopt;
+    }
+
+    // Rosser's bound: p_k < k (ln k + ln ln k) for k >= 6.
+    double kd = k;
+    int64_t bound = k < 6 ? 13 : static_cast<int64_t>(kd * (std::log(kd) + std::log(std::log(kd)))) + 1;
+    ensure(bound);
+    if (primesBelow(std::min(limit(), maxCached) + 1) < k) {
+        return std::nullopt;
+    }
+
+    // Last word whose prefix is still below k holds the k-th prime.
+    auto it = std::lower_bound(wordPrefix.begin(), wordPrefix.end(), k);
+    size_t word = static_cast<size_t>(it - wordPrefix.begin()) - 1;
+    uint64_t value = bits[word];
+    for (uint32_t skip = k - wordPrefix[word] - 1; skip > 0; --skip) {
+        value &= value - 1;
+    }
+    return static_cast<int>(word * 64 + std::countr_zero(value));
+}
+
+// Find the next prime by scanning cached words, growing the cache when needed.
+std::optional<int> PrimeCache::nextPrime(int n) {
+    int64_t candidate = std::max<int64_t>(static_cast<int64_t>(n) + 1, 2);
+    while (candidate <= maxCached) {
+        ensure(std::min(maxCached, candidate + 1024));
+        for (int64_t word = candidate / 64; word < static_cast<int64_t>(bits.size()); ++word) {
+            uint64_t value = bits[word];
+            if (word == candidate / 64) {
+                value &= ~uint64_t{0} << (candidate % 64);
+            }
+            if (value != 0) {
+                int64_t prime = word * 64 + std::countr_zero(value);
+                return prime <= maxCached ? std::optional<int>(static_cast<int>(prime)) : std::nullopt;
+            }
+        }
+        candidate = limit() + 1;
+    }
+    return std::nullopt;
+}
@@ -1,10 +1,50 @@
 #include "PrimeFinderFactory.h"
+#include "AsyncOutputWriter.h"
 #include "BatchPrintStrategy.h"
+#include "BinaryPrintStrategy.h"
+#include "ClusterDivisionStrategy.h"
+#include "ConfigParser.h"
+#include "CountPrintStrategy.h"
+#include "FilePrintStrategy.h"
 #include "ImmediatePrintStrategy.h"
+#include "LivePrintStrategy.h"
+#include "OrderedPrintStrategy.h"
+#include "PrimeFinder.h"
+#include "ProcessDivisionStrategy.h"
 #include "QueueDivisionStrategy.h"
 #include "RangeDivisionStrategy.h"
+#include "ShardedPrintStrategy.h"
+#include "StructuredPrintStrategy.h"
+#include "UringOutputWriter.h"
 #include <algorithm>
 #include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+constexpr const char *DEFAULT_BINARY_FILE = "primes.bin"; // Binary output never goes to the terminal
+constexpr const char *DEFAULT_TEXT_FILE = "primes.txt";   // File mode without output_file
+constexpr const char *DEFAULT_SHARD_DIR = "primes_shards"; // Sharded mode without shard_dir
+
+// Record format of a structured print mode.
+StructuredFormat structuredFormat(PrintMode mode) {
+    return mode == PrintMode::CSV ? StructuredFormat::CSV : StructuredFormat::NDJSON;
+}
+
+// Path the file print mode writes to.
+std::string textFilePath(const Config &config) {
+    return config.outputFile.empty() ? DEFAULT_TEXT_FILE : config.outputFile;
+}
+
+// Where the live print mode sends every prime: output_file when set, nowhere otherwise.
+std::shared_ptr<IPrintStrategy> liveFullResults(const Config &config, std::shared_ptr<IOutputWriter> writer) {
+    if (config.outputFile.empty()) {
+        return nullptr;
+    }
+    return std::make_shared<FilePrintStrategy>(config.outputFile, std::move(writer));
+}
+
+} // namespace
 
 // Create print strategy based on mode.
 std::shared_ptr<IPrintStrategy> PrimeFinderFactory::createPrintStrategy(PrintMode mode) {
@@ -13,11 +53,129 @@ std::shared_ptr<IPrintStrategy> PrimeFinderFactory::createPrintStrategy(PrintMod
         return std::make_shared<ImmediatePrintStrategy>();
     case PrintMode::BATCH:
         return std::make_shared<BatchPrintStrategy>();
+    case PrintMode::BINARY:
+        return std::make_shared<BinaryPrintStrategy>(FdOutputWriter::openFile(DEFAULT_BINARY_FILE));
+    case PrintMode::TEXT_FILE:
+        return std::make_shared<FilePrintStrategy>(DEFAULT_TEXT_FILE);
+    case PrintMode::COUNT:
+        return std::make_shared<CountPrintStrategy>();
+    case PrintMode::ORDERED:
+        return std::make_shared<OrderedPrintStrategy>();
+    case PrintMode::LIVE:
+        return std::make_shared<LivePrintStrategy>();
+    case PrintMode::SHARDED:
+        return std::make_shared<ShardedPrintStrategy>(DEFAULT_SHARD_DIR);
+    case PrintMode::NDJSON:
+    case PrintMode::CSV:
+        return createPrintStrategy(mode, std::make_shared<FdOutputWriter>(STDOUT_FILENO));
     default:
         throw std::invalid_argument("Unknown print mode");
     }
 }
 
+// Create print strategy writing to the given writer.
+std::shared_ptr<IPrintStrategy>
+PrimeFinderFactory::createPrintStrategy(PrintMode mode, std::shared_ptr<IOutputWriter> writer) {
+    switch (mode) {
+    case PrintMode::IMMEDIATE:
+        return std::make_shared<ImmediatePrintStrategy>(std::move(writer));
+    case PrintMode::BATCH:
+        return std::make_shared<BatchPrintStrategy>(std::move(writer));
+    case PrintMode::BINARY:
+        return std::make_shared<BinaryPrintStrategy>(std::move(writer));
+    case PrintMode::TEXT_FILE:
+        return std::make_shared<FilePrintStrategy>(DEFAULT_TEXT_FILE, std::move(writer));
+    case PrintMode::COUNT:
+        return std::make_shared<CountPrintStrategy>(std::move(writer));
+    case PrintMode::ORDERED:
+        return std::make_shared<OrderedPrintStrategy>(std::move(writer));
+    case PrintMode::LIVE:
+        return std::make_shared<LivePrintStrategy>(std::move(writer));
+    case PrintMode::SHARDED:
+        return std::make_shared<ShardedPrintStrategy>(DEFAULT_SHARD_DIR, ShardFormat::TEXT,
+                                                      std::move(writer));
+    case PrintMode::NDJSON:
+        return std::make_shared<StructuredPrintStrategy>(std::move(writer), StructuredFormat::NDJSON);
+    case PrintMode::CSV:
+        return std::make_shared<StructuredPrintStrategy>(std::move(writer), StructuredFormat::CSV);
+    default:
+        throw std::invalid_argument("Unknown print mode");
+    }
+}
+
+// Create the configured print strategy, applying its mode-specific settings.
+std::shared_ptr<IPrintStrategy>
+PrimeFinderFactory::createPrintStrategy(const Config &config, std::shared_ptr<IOutputWriter> writer) {
+    PrintMode mode = parsePrintMode(config.printMode);
+    switch (mode) {
+    case PrintMode::BINARY: {
+        BinaryEncoding encoding = BinaryPrintStrategy::parseEncoding(config.binaryEncoding);
+        return std::make_shared<BinaryPrintStrategy>(std::move(writer), encoding);
+    }
+    case PrintMode::TEXT_FILE:
+        return std::make_shared<FilePrintStrategy>(textFilePath(config), std::move(writer));
+    case PrintMode::ORDERED:
+        return std::make_shared<OrderedPrintStrategy>(std::move(writer), config.reorderWindow);
+    case PrintMode::LIVE: {
+        auto fullResults = liveFullResults(config, writer);
+        return std::make_shared<LivePrintStrategy>(std::move(writer), std::move(fullResults),
+                                                   config.frameRate);
+    }
+    case PrintMode::SHARDED: {
+        ShardFormat format = ShardedPrintStrategy::parseFormat(config.shardFormat);
+        return std::make_shared<ShardedPrintStrategy>(config.shardDir, format, std::move(writer));
+    }
+    case PrintMode::NDJSON:
+    case PrintMode::CSV:
+        return std::make_shared<StructuredPrintStrategy>(std::move(writer), structuredFormat(mode), config);
+    default:
+        return createPrintStrategy(mode, std::move(writer));
+    }
+}
+
+// Create the writer for standard output.
+std::shared_ptr<IOutputWriter> PrimeFinderFactory::createOutputWriter(const Config &config) {
+    PrintMode mode = parsePrintMode(config.printMode);
+    // The async stage only fronts primes written to standard output with write(2).
+    bool ownsFile = mode == PrintMode::TEXT_FILE || mode == PrintMode::LIVE || mode == PrintMode::SHARDED;
+    bool toFile = ownsFile || mode == PrintMode::BINARY || !config.outputFile.empty();
+    if (config.outputIo != "write" && config.outputIo != "uring") {
+        throw std::invalid_argument("Invalid output_io: " + config.outputIo);
+    }
+    if (ownsFile && config.outputIo == "uring") {
+        throw std::invalid_argument("output_io = uring does not apply to the file, live and sharded "
+                                    "print modes, which write their own files");
+    }
+    if (config.outputBackpressure != "off" && (toFile || config.outputIo == "uring")) {
+        throw std::invalid_argument("output_backpressure only applies to standard output written with "
+                                    "output_io = write");
+    }
+    if (ownsFile) {
+        // Only the summary and live frames go here; the print strategy owns the file.
+        return std::make_shared<FdOutputWriter>(STDOUT_FILENO);
+    }
+    if (config.outputIo == "uring") {
+        if (!config.outputFile.empty()) {
+            return UringOutputWriter::openFile(config.outputFile);
+        }
+        if (mode == PrintMode::BINARY) {
+            return UringOutputWriter::openFile(DEFAULT_BINARY_FILE);
+        }
+        return std::make_shared<UringOutputWriter>(STDOUT_FILENO);
+    }
+    if (!config.outputFile.empty()) {
+        return FdOutputWriter::openFile(config.outputFile);
+    }
+    if (mode == PrintMode::BINARY) {
+        return FdOutputWriter::openFile(DEFAULT_BINARY_FILE);
+    }
+    if (config.outputBackpressure == "off") {
+        return std::make_shared<FdOutputWriter>(STDOUT_FILENO);
+    }
+    return std::make_shared<AsyncOutputWriter>(STDOUT_FILENO,
+                                               AsyncOutputWriter::parsePolicy(config.outputBackpressure));
+}
+
 // Create division strategy based on mode.
 std::shared_ptr<ITaskDivisionStrategy> PrimeFinderFactory::createDivisionStrategy(DivisionMode mode) {
     switch (mode) {
@@ -25,11 +183,93 @@ std::shared_ptr<ITaskDivisionStrategy> PrimeFinderFactory::createDivisionStrateg
         return std::make_shared<RangeDivisionStrategy>();
     case DivisionMode::QUEUE:
         return std::make_shared<QueueDivisionStrategy>();
+    case DivisionMode::PROCESS:
+        return std::make_shared<ProcessDivisionStrategy>();
+    case DivisionMode::CLUSTER:
+        return std::make_shared<ClusterDivisionStrategy>();
     default:
         throw std::invalid_argument("Unknown division mode");
     }
 }
 
+// Create division strategy from configuration.
+std::shared_ptr<ITaskDivisionStrategy> PrimeFinderFactory::createDivisionStrategy(const Config &config) {
+    DivisionMode mode = parseDivisionMode(config.divisionMode);
+    if (mode == DivisionMode::CLUSTER) {
+        return std::make_shared<ClusterDivisionStrategy>(config.clusterPort,
+                                                         std::chrono::milliseconds(config.leaseTimeoutMs));
+    }
+    return createDivisionStrategy(mode);
+}
+
+// Pick the sink for a division strategy with a templated search.
+template <typename Division>
+static Task<PrimeSearchResult> findPrimesWithSink(PrintMode mode, const Config &config, SearchOptions options,
+                                                  std::shared_ptr<IOutputWriter> writer) {
+    switch (mode) {
+    case PrintMode::IMMEDIATE:
+        return PrimeFinder<Division, ImmediatePrintStrategy>(std::move(writer))
+            .findPrimesAsync(config.upperLimit, config.threads, std::move(options));
+    case PrintMode::BATCH:
+        return PrimeFinder<Division, BatchPrintStrategy>(std::move(writer))
+            .findPrimesAsync(config.upperLimit, config.threads, std::move(options));
+    case PrintMode::BINARY: {
+        BinaryEncoding encoding = BinaryPrintStrategy::parseEncoding(config.binaryEncoding);
+        return PrimeFinder<Division, BinaryPrintStrategy>(std::move(writer), encoding)
+            .findPrimesAsync(config.upperLimit, config.threads, std::move(options));
+    }
+    case PrintMode::TEXT_FILE:
+        return PrimeFinder<Division, FilePrintStrategy>(textFilePath(config), std::move(writer))
+            .findPrimesAsync(config.upperLimit, config.threads, std::move(options));
+    case PrintMode::COUNT:
+        return PrimeFinder<Division, CountPrintStrategy>(std::move(writer))
+            .findPrimesAsync(config.upperLimit, config.threads, std::move(options));
+    case PrintMode::ORDERED:
+        return PrimeFinder<Division, OrderedPrintStrategy>(std::move(writer), config.reorderWindow)
+            .findPrimesAsync(config.upperLimit, config.threads, std::move(options));
+    case PrintMode::LIVE: {
+        auto fullResults = liveFullResults(config, writer);
+        return PrimeFinder<Division, LivePrintStrategy>(std::move(writer), std::move(fullResults),
+                                                        config.frameRate)
+            .findPrimesAsync(config.upperLimit, config.threads, std::move(options));
+    }
+    case PrintMode::SHARDED: {
+        ShardFormat format = ShardedPrintStrategy::parseFormat(config.shardFormat);
+        return PrimeFinder<Division, ShardedPrintStrategy>(config.shardDir, format, std::move(writer))
+            .findPrimesAsync(config.upperLimit, config.threads, std::move(options));
+    }
+    case PrintMode::NDJSON:
+    case PrintMode::CSV:
+        return PrimeFinder<Division, StructuredPrintStrategy>(std::move(writer), structuredFormat(mode),
+                                                              config)
+            .findPrimesAsync(config.upperLimit, config.threads, std::move(options));
+    default:
+        throw std::invalid_argument("Unknown print mode");
+    }
+}
+
+// Dispatch once to the compile-time combination; other modes go through the virtual interfaces.
+Task<PrimeSearchResult> PrimeFinderFactory::findPrimesAsync(const Config &config, SearchOptions options,
+                                                            std::shared_ptr<IOutputWriter> writer) {
+    PrintMode printMode = parsePrintMode(config.printMode);
+    if (!writer) {
+        writer = createOutputWriter(config);
+    }
+
+    switch (parseDivisionMode(config.divisionMode)) {
+    case DivisionMode::RANGE:
+        return findPrimesWithSink<RangeDivisionStrategy>(printMode, config, std::move(options),
+                                                         std::move(writer));
+    case DivisionMode::QUEUE:
+        return findPrimesWithSink<QueueDivisionStrategy>(printMode, config, std::move(options),
+                                                         std::move(writer));
+    default:
+        auto printStrategy = createPrintStrategy(config, std::move(writer));
+        return createDivisionStrategy(config)->findPrimesAsync(config.upperLimit, config.threads,
+                                                               std::move(printStrategy), std::move(options));
+    }
+}
+
 // Parse print mode from string.
 PrintMode PrimeFinderFactory::parsePrintMode(const std::string &mode) {
     std::string lowerMode = mode;
@@ -39,6 +279,22 @@ PrintMode PrimeFinderFactory::parsePrintMode(const std::string &mode) {
         return PrintMode::IMMEDIATE;
     } else if (lowerMode == "batch") {
         return PrintMode::BATCH;
+    } else if (lowerMode == "binary") {
+        return PrintMode::BINARY;
+    } else if (lowerMode == "file") {
+        return PrintMode::TEXT_FILE;
+    } else if (lowerMode == "count") {
+        return PrintMode::COUNT;
+    } else if (lowerMode == "ordered") {
+        return PrintMode::ORDERED;
+    } else if (lowerMode == "live") {
+        return PrintMode::LIVE;
+    } else if (lowerMode == "sharded") {
+        return PrintMode::SHARDED;
+    } else if (lowerMode == "ndjson") {
+        return PrintMode::NDJSON;
+    } else if (lowerMode == "csv") {
+        return PrintMode::CSV;
     } else {
         throw std::invalid_argument("Invalid print mode: " + mode);
     }
@@ -53,6 +309,10 @@ DivisionMode PrimeFinderFactory::parseDivisionMode(const std::string &mode) {
         return DivisionMode::RANGE;
     } else if (lowerMode == "queue") {
         return DivisionMode::QUEUE;
+    } else if (lowerMode == "process") {
+        return DivisionMode::PROCESS;
+    } else if (lowerMode == "cluster") {
+        return DivisionMode::CLUSTER;
     } else {
         throw std::invalid_argument("Invalid division mode: " + mode);
     }
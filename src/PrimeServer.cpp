@@ -0,0 +1,194 @@
+#include "PrimeServer.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Per-connection buffers.
+struct Client {
+    int fd;
+    std::string input;
+    std::string output;
+    bool inputClosed = false; // The client shut down its side; close once output has drained
+};
+
+// Stop reading from clients that do not drain their responses.
+constexpr size_t MAX_PENDING_OUTPUT = 16 * 1024 * 1024;
+
+void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK); }
+
+} // namespace
+
+// Serve from the given cache.
+PrimeServer::PrimeServer(PrimeCache &primeCache) : cache(primeCache) {}
+
+// Close the listener and remove the socket file.
+PrimeServer::~PrimeServer() {
+    if (listener >= 0) {
+        close(listener);
+        unlink(socketPath.c_str());
+    }
+}
+
+// Bind and listen on a Unix domain socket.
+bool PrimeServer::listen(const std::string &path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || ::listen(fd, 64) < 0) {
+        close(fd);
+        return false;
+    }
+    setNonBlocking(fd);
+    listener = fd;
+    socketPath = path;
+    return true;
+}
+
+// Compute the answer to one request.
+QueryResponse PrimeServer::answer(const QueryRequest &request) {
+    QueryResponse response;
+    response.id = request.id;
+    auto fail = [&response](QueryStatus status) {
+        response.status = status;
+        return response;
+    };
+
+    const uint64_t maxLimit = static_cast<uint64_t>(cache.ceiling());
+    switch (request.op) {
+    case QueryOp::IS_PRIME:
+        if (request.a > maxLimit) {
+            return fail(QueryStatus::OUT_OF_RANGE);
+        }
+        response.values.push_back(cache.isPrime(static_cast<int>(request.a)) ? 1 : 0);
+        return response;
+    case QueryOp::COUNT:
+    case QueryOp::RANGE:
+        if (request.a > request.b) {
+            return fail(QueryStatus::BAD_REQUEST);
+        }
+        if (request.b > maxLimit) {
+            return fail(QueryStatus::OUT_OF_RANGE);
+        }
+        if (request.op == QueryOp::COUNT) {
+            response.values.push_back(cache.count(static_cast<int>(request.a), static_cast<int>(request.b)));
+        } else if (!cache.collect(static_cast<int>(request.a), static_cast<int>(request.b), MAX_RANGE_VALUES,
+                                  response.values)) {
+            return fail(QueryStatus::TOO_LARGE);
+        }
+        return response;
+    case QueryOp::NTH_PRIME: {
+        if (request.a == 0 || request.a > UINT32_MAX) {
+            return fail(request.a == 0 ? QueryStatus::BAD_REQUEST : QueryStatus::OUT_OF_RANGE);
+        }
+        auto prime = cache.nthPrime(static_cast<uint32_t>(request.a));
+        if (!prime) {
+            return fail(QueryStatus::OUT_OF_RANGE);
+        }
+        response.values.push_back(static_cast<uint32_t>(*prime));
+        return response;
+    }
+    case QueryOp::NEXT_PRIME: {
+        auto prime = request.a < maxLimit ? cache.nextPrime(static_cast<int>(request.a)) : std::nullopt;
+        if (!prime) {
+            return fail(QueryStatus::OUT_OF_RANGE);
+        }
+        response.values.push_back(static_cast<uint32_t>(*prime));
+        return response;
+    }
+    }
+    return fail(QueryStatus::BAD_REQUEST);
+}
+
+// Poll loop: accept clients, answer every complete request, flush responses.
+void PrimeServer::run(std::stop_token stop) {
+    std::vector<Client> clients;
+    std::vector<pollfd> fds;
+    char chunk[64 * 1024];
+
+    while (!stop.stop_requested()) {
+        fds.clear();
+        fds.push_back({listener, POLLIN, 0});
+        for (const Client &client : clients) {
+            short events = !client.inputClosed && client.output.size() < MAX_PENDING_OUTPUT ? POLLIN : 0;
+            if (!client.output.empty()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({client.fd, events, 0});
+        }
+        if (poll(fds.data(), fds.size(), 50) <= 0) {
+            continue;
+        }
+
+        // Serve existing clients; accepted ones join on the next pass.
+        for (size_t i = 0; i < clients.size(); ++i) {
+            Client &client = clients[i];
+            short revents = fds[i + 1].revents;
+            bool open = (revents & (POLLERR | POLLNVAL)) == 0;
+
+            if (open && !client.inputClosed && (revents & (POLLIN | POLLHUP))) {
+                ssize_t received = read(client.fd, chunk, sizeof(chunk));
+                if (received > 0) {
+                    client.input.append(chunk, static_cast<size_t>(received));
+                } else if (received == 0) {
+                    client.inputClosed = true; // Still answer what arrived before the half-close.
+                } else if (errno != EAGAIN && errno != EINTR) {
+                    open = false;
+                }
+            }
+
+            size_t consumed = 0;
+            while (open && client.input.size() - consumed >= QueryProtocol::REQUEST_SIZE) {
+                std::string_view bytes(client.input.data() + consumed, QueryProtocol::REQUEST_SIZE);
+                QueryProtocol::encodeResponse(client.output, answer(QueryProtocol::decodeRequest(bytes)));
+                consumed += QueryProtocol::REQUEST_SIZE;
+                ++served;
+            }
+            client.input.erase(0, consumed);
+
+            if (open && !client.output.empty()) {
+                ssize_t written = send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+                if (written > 0) {
+                    client.output.erase(0, static_cast<size_t>(written));
+                } else if (written < 0 && errno != EAGAIN && errno != EINTR) {
+                    open = false;
+                }
+            }
+
+            if (open && client.inputClosed && client.output.empty()) {
+                open = false;
+            }
+            if (!open) {
+                close(client.fd);
+                client.fd = -1;
+            }
+        }
+        std::erase_if(clients, [](const Client &client) { return client.fd < 0; });
+
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                clients.push_back({fd, {}, {}});
+            }
+        }
+    }
+
+    for (const Client &client : clients) {
+        close(client.fd);
+    }
+}
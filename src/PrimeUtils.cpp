@@ -1,5 +1,6 @@
 #include "PrimeUtils.h"
 #include <algorithm>
+#include <bit>
 #include <cmath>
 
 // Check if number is prime using trial division.
@@ -77,3 +78,73 @@ std::vector<int> PrimeUtils::getKnownPrimes(int limit) {
 
     return primes;
 }
+
+// Sieve [start, end) into a bitmap using the given base primes.
+void PrimeUtils::sieveSegment(int64_t start, int64_t end, const std::vector<int> &basePrimes,
+                              uint64_t *bits) {
+    if (start >= end) {
+        return;
+    }
+
+    // Start with every candidate marked, then clear 0, 1 and the tail past end.
+    int64_t length = end - start;
+    size_t words = static_cast<size_t>((length + 63) / 64);
+    std::fill(bits, bits + words, ~uint64_t{0});
+    if (length % 64 != 0) {
+        bits[words - 1] = (uint64_t{1} << (length % 64)) - 1;
+    }
+    for (int64_t n = start; n < std::min<int64_t>(end, 2); ++n) {
+        bits[(n - start) / 64] &= ~(uint64_t{1} << ((n - start) % 64));
+    }
+
+    // Cross off multiples of each base prime, starting at its square.
+    for (int prime : basePrimes) {
+        int64_t p = prime;
+        if (p * p >= end) {
+            break;
+        }
+        int64_t first = std::max(p * p, (start + p - 1) / p * p);
+        for (int64_t multiple = first; multiple < end; multiple += p) {
+            int64_t offset = multiple - start;
+            bits[offset / 64] &= ~(uint64_t{1} << (offset % 64));
+        }
+    }
+}
+
+// Turn set bits back into numbers.
+void PrimeUtils::appendSegmentPrimes(int64_t start, int64_t length, const uint64_t *bits,
+                                     std::vector<int> &out) {
+    size_t words = static_cast<size_t>((length + 63) / 64);
+    for (size_t word = 0; word < words; ++word) {
+        for (uint64_t value = bits[word]; value != 0; value &= value - 1) {
+            int64_t offset = static_cast<int64_t>(word) * 64 + std::countr_zero(value);
+            out.push_back(static_cast<int>(start + offset));
+        }
+    }
+}
+
+// Count set bits a word at a time; sieveSegment leaves the tail past length clear.
+size_t PrimeUtils::countSegmentPrimes(int64_t length, const uint64_t *bits) {
+    size_t words = static_cast<size_t>((length + 63) / 64);
+    size_t count = 0;
+    for (size_t word = 0; word < words; ++word) {
+        count += static_cast<size_t>(std::popcount(bits[word]));
+    }
+    return count;
+}
+
+// Sieve a segment and count it without listing its primes.
+size_t PrimeUtils::countPrimesInSegment(int64_t start, int64_t end, const std::vector<int> &basePrimes,
+                                        std::vector<uint64_t> &scratch) {
+    if (start >= end) {
+        return 0;
+    }
+    scratch.resize(static_cast<size_t>((end - start + 63) / 64));
+    sieveSegment(start, end, basePrimes, scratch.data());
+    return countSegmentPrimes(end - start, scratch.data());
+}
+
+// Primes up to the square root of limit, plus one for rounding.
+std::vector<int> PrimeUtils::basePrimesFor(int limit) {
+    return getKnownPrimes(static_cast<int>(std::sqrt(static_cast<double>(std::max(0, limit)))) + 1);
+}
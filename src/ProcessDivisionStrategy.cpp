@@ -0,0 +1,300 @@
+#include "ProcessDivisionStrategy.h"
+#include "ColorUtils.h"
+#include "Console.h"
+#include "EventClock.h"
+#include "IPrintStrategy.h"
+#include "PrimeUtils.h"
+#include "SearchJob.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Define static mutex for console output protection.
+std::mutex ProcessDivisionStrategy::consoleMutex;
+
+namespace {
+
+// Segment states in shared memory; any positive value is the pid of the claiming worker.
+constexpr int32_t SEGMENT_FREE = 0;
+constexpr int32_t SEGMENT_DONE = -1;
+constexpr int32_t SEGMENT_FAILED = -2;
+
+constexpr int BITS_PER_WORD = 64;
+
+// Anonymous shared mapping inherited by forked workers.
+//
+// Layout: claim cursor, one state and one attempt counter per segment, then the prime bitmap.
+// Segments cover whole bitmap words, so no two workers ever write the same word.
+class SharedRegion {
+public:
+    SharedRegion(size_t segmentCount, size_t wordCount) : segments(segmentCount), words(wordCount) {
+        size = sizeof(std::atomic<uint32_t>) + 2 * segmentCount * sizeof(std::atomic<int32_t>);
+        size = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+        bitmapOffset = size;
+        size += wordCount * sizeof(uint64_t);
+
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            throw std::runtime_error("Failed to map shared memory for worker processes");
+        }
+
+        // The mapping is zero-filled, which is a valid initial state for all fields.
+        auto *bytes = static_cast<char *>(base);
+        cursor = new (bytes) std::atomic<uint32_t>(0);
+        states = reinterpret_cast<std::atomic<int32_t> *>(bytes + sizeof(std::atomic<uint32_t>));
+        attempts = states + segmentCount;
+        for (size_t i = 0; i < segmentCount; ++i) {
+            new (&states[i]) std::atomic<int32_t>(SEGMENT_FREE);
+            new (&attempts[i]) std::atomic<int32_t>(0);
+        }
+        bitmap = reinterpret_cast<uint64_t *>(bytes + bitmapOffset);
+    }
+
+    ~SharedRegion() { munmap(base, size); }
+
+    SharedRegion(const SharedRegion &) = delete;
+    SharedRegion &operator=(const SharedRegion &) = delete;
+
+    size_t segments;
+    size_t words;
+    std::atomic<uint32_t> *cursor = nullptr;
+    std::atomic<int32_t> *states = nullptr;
+    std::atomic<int32_t> *attempts = nullptr;
+    uint64_t *bitmap = nullptr;
+
+private:
+    void *base = nullptr;
+    size_t size = 0;
+    size_t bitmapOffset = 0;
+};
+
+// Claim the next free segment, first from the cursor and then by scanning for reassigned ones.
+long claimSegment(SharedRegion &shared, int32_t pid) {
+    while (true) {
+        uint32_t next = shared.cursor->fetch_add(1);
+        if (next >= shared.segments) {
+            break;
+        }
+        int32_t expected = SEGMENT_FREE;
+        if (shared.states[next].compare_exchange_strong(expected, pid)) {
+            return next;
+        }
+    }
+
+    for (size_t i = 0; i < shared.segments; ++i) {
+        int32_t expected = SEGMENT_FREE;
+        if (shared.states[i].compare_exchange_strong(expected, pid)) {
+            return static_cast<long>(i);
+        }
+    }
+    return -1;
+}
+
+// Worker process body: sieve claimed segments into the shared bitmap, then exit without unwinding.
+[[noreturn]] void runWorker(SharedRegion &shared, const std::vector<Segment> &segments,
+                            const std::function<void(const Segment &, int)> &hook) {
+    int32_t pid = static_cast<int32_t>(getpid());
+    long index;
+    while ((index = claimSegment(shared, pid)) >= 0) {
+        const Segment &segment = segments[index];
+        int attempt = shared.attempts[index].fetch_add(1) + 1;
+        if (hook) {
+            hook(segment, attempt);
+        }
+
+        // No allocation here: test candidates one by one and set bits in place.
+        for (int number = std::max(2, segment.start); number <= segment.end; ++number) {
+            if (PrimeUtils::isPrime(number)) {
+                shared.bitmap[number / BITS_PER_WORD] |= uint64_t{1} << (number % BITS_PER_WORD);
+            }
+        }
+        shared.states[index].store(SEGMENT_DONE);
+    }
+    _exit(0);
+}
+
+// Fork one worker process.
+pid_t spawnWorker(SharedRegion &shared, const std::vector<Segment> &segments,
+                  const std::function<void(const Segment &, int)> &hook) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("Failed to fork worker process");
+    }
+    if (pid == 0) {
+        runWorker(shared, segments, hook);
+    }
+    return pid;
+}
+
+} // namespace
+
+// Install a per-segment callback run inside worker processes.
+void ProcessDivisionStrategy::setSegmentHook(std::function<void(const Segment &, int)> hook) {
+    segmentHook = std::move(hook);
+}
+
+// Find primes with forked worker processes; the coordinator runs on the shared pool.
+Task<PrimeSearchResult>
+ProcessDivisionStrategy::findPrimesAsync(int upperLimit, int numThreads,
+                                         std::shared_ptr<IPrintStrategy> printStrategy,
+                                         SearchOptions options) {
+    numThreads = std::max(1, numThreads);
+    {
+        std::lock_guard<std::mutex> lock(consoleMutex);
+        Console::status() << ColorUtils::highlight("[PROCESS DIVISION]") << " Finding primes up to "
+                          << ColorUtils::bold(std::to_string(upperLimit)) << " using "
+                          << ColorUtils::bold(std::to_string(numThreads)) << " worker processes" << std::endl;
+    }
+
+    auto job = std::make_shared<SearchJob>(std::move(printStrategy), std::move(options), 1);
+    ThreadPool &pool = ThreadPool::shared();
+    pool.ensureWorkers(1);
+
+    pool.submit([upperLimit, numThreads, job, hook = segmentHook]() {
+        try {
+            coordinate(upperLimit, numThreads, *job, hook);
+        } catch (...) {
+            job->fail(std::current_exception());
+        }
+
+        if (job->finishWorker()) {
+            if (job->stopped()) {
+                std::lock_guard<std::mutex> lock(consoleMutex);
+                Console::status() << ColorUtils::warning("[PROCESS DIVISION] Incomplete") << " - returning "
+                                  << ColorUtils::bold(std::to_string(job->primeCount()))
+                                  << " primes from completed segments" << std::endl;
+            }
+            job->complete();
+        }
+    });
+
+    return job->task();
+}
+
+// Fork workers, merge finished segments, and replace workers that die.
+void ProcessDivisionStrategy::coordinate(int upperLimit, int numProcesses, SearchJob &job,
+                                         const std::function<void(const Segment &, int)> &hook) {
+    if (upperLimit < 2) {
+        return;
+    }
+
+    // Round segments up to whole bitmap words so workers never share a word.
+    int segmentSize = std::max(1, job.options().segmentSize);
+    segmentSize = (segmentSize + BITS_PER_WORD - 1) / BITS_PER_WORD * BITS_PER_WORD;
+    std::vector<Segment> segments = SegmentPlanner::split(0, upperLimit, segmentSize);
+    if (job.options().progress) {
+        job.options().progress->setTotals(static_cast<uint64_t>(upperLimit) + 1, segments.size());
+    }
+
+    SharedRegion shared(segments.size(), static_cast<size_t>(upperLimit) / BITS_PER_WORD + 1);
+    std::vector<pid_t> workers;
+    std::vector<bool> merged(segments.size(), false);
+    size_t mergedCount = 0;
+
+    // Hand every newly finished segment to the print strategy and the result.
+    auto mergeFinished = [&]() {
+        for (size_t i = 0; i < segments.size(); ++i) {
+            if (merged[i] || shared.states[i].load() != SEGMENT_DONE) {
+                continue;
+            }
+
+            const Segment &segment = segments[i];
+            std::vector<int> segmentPrimes;
+            for (int word = segment.start / BITS_PER_WORD; word <= segment.end / BITS_PER_WORD; ++word) {
+                for (uint64_t bits = shared.bitmap[word]; bits != 0; bits &= bits - 1) {
+                    segmentPrimes.push_back(word * BITS_PER_WORD + __builtin_ctzll(bits));
+                }
+            }
+            SegmentInfo info{segment, 0, std::this_thread::get_id(), EventClock::now()};
+            job.printStrategy()->printPrimes(segmentPrimes, info);
+            job.commitSegment(0, segment, segmentPrimes);
+            merged[i] = true;
+            ++mergedCount;
+        }
+    };
+
+    // Return a dead worker's unfinished segments to the queue, or give up on them after too many tries.
+    auto reassignSegments = [&](pid_t pid) {
+        for (size_t i = 0; i < segments.size(); ++i) {
+            if (shared.states[i].load() != pid) {
+                continue;
+            }
+            int firstWord = segments[i].start / BITS_PER_WORD;
+            int lastWord = segments[i].end / BITS_PER_WORD;
+            std::fill(shared.bitmap + firstWord, shared.bitmap + lastWord + 1, 0); // Discard partial output.
+            bool exhausted = shared.attempts[i].load() >= MAX_SEGMENT_ATTEMPTS;
+            shared.states[i].store(exhausted ? SEGMENT_FAILED : SEGMENT_FREE);
+
+            std::lock_guard<std::mutex> lock(consoleMutex);
+            Console::status() << ColorUtils::warning("[PROCESS DIVISION] Worker " + std::to_string(pid) +
+                                                     " died")
+                              << " - segment " << segments[i].start << "-" << segments[i].end
+                              << (exhausted ? " abandoned" : " reassigned") << std::endl;
+        }
+    };
+
+    auto hasFreeSegments = [&]() {
+        for (size_t i = 0; i < segments.size(); ++i) {
+            if (shared.states[i].load() == SEGMENT_FREE) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (int i = 0; i < numProcesses; ++i) {
+        workers.push_back(spawnWorker(shared, segments, hook));
+    }
+
+    while (!workers.empty()) {
+        mergeFinished();
+
+        if (job.shouldStop()) {
+            for (pid_t pid : workers) {
+                kill(pid, SIGKILL);
+            }
+            for (pid_t pid : workers) {
+                waitpid(pid, nullptr, 0);
+            }
+            workers.clear();
+            break;
+        }
+
+        // Reap exited workers and replace the ones that failed while work remains.
+        int failures = 0;
+        for (auto it = workers.begin(); it != workers.end();) {
+            int status = 0;
+            if (waitpid(*it, &status, WNOHANG) == *it) {
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                    reassignSegments(*it);
+                    ++failures;
+                }
+                it = workers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (int i = 0; i < failures && hasFreeSegments(); ++i) {
+            workers.push_back(spawnWorker(shared, segments, hook));
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    mergeFinished();
+
+    // Abandoned segments leave a hole in the result, so report it as incomplete.
+    if (mergedCount < segments.size()) {
+        job.markIncomplete();
+    }
+}
@@ -0,0 +1,96 @@
+#include "ProgressReporter.h"
+#include "ColorUtils.h"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Open the output and start sampling.
+ProgressReporter::ProgressReporter(std::shared_ptr<const ProgressTracker> progressTracker,
+                                   std::chrono::milliseconds reportInterval, const std::string &outputPath)
+    : tracker(std::move(progressTracker)), interval(reportInterval), output(&std::cerr),
+      startTime(std::chrono::steady_clock::now()) {
+    if (!outputPath.empty() && outputPath != "stderr") {
+        file.open(outputPath, std::ios::app);
+        if (file.is_open()) {
+            output = &file;
+        } else {
+            std::cerr << ColorUtils::warning("Cannot open progress output '" + outputPath + "', using stderr")
+                      << std::endl;
+        }
+    }
+    thread = std::thread([this]() { run(); });
+}
+
+// Stop the sampling thread if still running.
+ProgressReporter::~ProgressReporter() { stop(); }
+
+// Wake the sampling thread, let it print a final report and join it.
+void ProgressReporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+// Sample the tracker every interval until stopped.
+void ProgressReporter::run() {
+    ProgressTracker::Snapshot previous = tracker->snapshot();
+    auto previousTime = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wakeup.wait_for(lock, interval, [this]() { return stopping; })) {
+        report(previous, previousTime);
+    }
+    report(previous, previousTime);
+}
+
+// Print one report and remember the sample for the next rate computation.
+void ProgressReporter::report(ProgressTracker::Snapshot &previous,
+                              std::chrono::steady_clock::time_point &previousTime) {
+    auto now = std::chrono::steady_clock::now();
+    ProgressTracker::Snapshot current = tracker->snapshot();
+    *output << formatReport(current, previous, now - previousTime, now - startTime) << std::endl;
+    previous = current;
+    previousTime = now;
+}
+
+// Render percentage, counters, recent rate and ETA.
+std::string ProgressReporter::formatReport(const ProgressTracker::Snapshot &current,
+                                           const ProgressTracker::Snapshot &previous,
+                                           std::chrono::duration<double> interval,
+                                           std::chrono::duration<double> elapsed) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << "[PROGRESS] ";
+
+    if (current.totalCandidates > 0) {
+        ss << 100.0 * static_cast<double>(current.candidates) / static_cast<double>(current.totalCandidates)
+           << "% | ";
+    }
+    ss << current.segments << "/" << current.totalSegments << " segments | " << current.candidates
+       << " candidates | " << current.primes << " primes";
+
+    // The rate uses the last interval so it follows slowdowns; the ETA uses the whole run for stability.
+    double rate = interval.count() > 0
+                      ? static_cast<double>(current.candidates - previous.candidates) / interval.count()
+                      : 0.0;
+    ss << " | " << rate << " candidates/s";
+
+    double averageRate =
+        elapsed.count() > 0 ? static_cast<double>(current.candidates) / elapsed.count() : 0.0;
+    uint64_t remaining = current.totalCandidates > current.candidates
+                             ? current.totalCandidates - current.candidates
+                             : 0;
+    if (current.totalCandidates > 0 && remaining == 0) {
+        ss << " | done in " << elapsed.count() << "s";
+    } else if (averageRate > 0 && remaining > 0) {
+        ss << " | ETA " << static_cast<double>(remaining) / averageRate << "s";
+    } else {
+        ss << " | ETA unknown";
+    }
+
+    return ss.str();
+}
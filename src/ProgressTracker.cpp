@@ -0,0 +1,33 @@
+#include "ProgressTracker.h"
+#include <algorithm>
+
+// Create one padded counter slot per worker.
+ProgressTracker::ProgressTracker(int workerCount) : workers(std::max(1, workerCount)) {}
+
+// Publish the totals of the search.
+void ProgressTracker::setTotals(uint64_t candidates, uint64_t segments) {
+    totalCandidates.store(candidates, std::memory_order_relaxed);
+    totalSegments.store(segments, std::memory_order_relaxed);
+}
+
+// Add a finished segment to the worker's own slot.
+void ProgressTracker::recordSegment(int worker, uint64_t candidates, uint64_t primes) {
+    WorkerCounters &slot = workers[static_cast<size_t>(worker) % workers.size()];
+
+    slot.candidates.fetch_add(candidates, std::memory_order_relaxed);
+    slot.segments.fetch_add(1, std::memory_order_relaxed);
+    slot.primes.fetch_add(primes, std::memory_order_relaxed);
+}
+
+// Sum the worker slots.
+ProgressTracker::Snapshot ProgressTracker::snapshot() const {
+    Snapshot snapshot;
+    for (const WorkerCounters &slot : workers) {
+        snapshot.candidates += slot.candidates.load(std::memory_order_relaxed);
+        snapshot.segments += slot.segments.load(std::memory_order_relaxed);
+        snapshot.primes += slot.primes.load(std::memory_order_relaxed);
+    }
+    snapshot.totalCandidates = totalCandidates.load(std::memory_order_relaxed);
+    snapshot.totalSegments = totalSegments.load(std::memory_order_relaxed);
+    return snapshot;
+}
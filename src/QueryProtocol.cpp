@@ -0,0 +1,71 @@
+#include "QueryProtocol.h"
+
+namespace {
+
+// Append a little-endian integer of the given width.
+template <typename T> void appendLE(std::string &out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// Read a little-endian integer of the given width at pos.
+template <typename T> T readLE(std::string_view in, size_t pos) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(static_cast<uint8_t>(in[pos + i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+// Serialize a request.
+void QueryProtocol::encodeRequest(std::string &out, const QueryRequest &request) {
+    out.push_back(static_cast<char>(request.op));
+    appendLE(out, request.id);
+    appendLE(out, request.a);
+    appendLE(out, request.b);
+}
+
+// Parse a request.
+QueryRequest QueryProtocol::decodeRequest(std::string_view bytes) {
+    QueryRequest request;
+    request.op = static_cast<QueryOp>(bytes[0]);
+    request.id = readLE<uint32_t>(bytes, 1);
+    request.a = readLE<uint64_t>(bytes, 5);
+    request.b = readLE<uint64_t>(bytes, 13);
+    return request;
+}
+
+// Serialize a response.
+void QueryProtocol::encodeResponse(std::string &out, const QueryResponse &response) {
+    out.reserve(out.size() + RESPONSE_HEADER_SIZE + 4 * response.values.size());
+    appendLE(out, response.id);
+    out.push_back(static_cast<char>(response.status));
+    appendLE(out, static_cast<uint32_t>(response.values.size()));
+    for (uint32_t value : response.values) {
+        appendLE(out, value);
+    }
+}
+
+// Parse a response once all its values have arrived.
+bool QueryProtocol::takeResponse(std::string &buffer, QueryResponse &response) {
+    if (buffer.size() < RESPONSE_HEADER_SIZE) {
+        return false;
+    }
+    uint32_t count = readLE<uint32_t>(buffer, 5);
+    size_t total = RESPONSE_HEADER_SIZE + 4 * static_cast<size_t>(count);
+    if (buffer.size() < total) {
+        return false;
+    }
+
+    response.id = readLE<uint32_t>(buffer, 0);
+    response.status = static_cast<QueryStatus>(buffer[4]);
+    response.values.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        response.values[i] = readLE<uint32_t>(buffer, RESPONSE_HEADER_SIZE + 4 * i);
+    }
+    buffer.erase(0, total);
+    return true;
+}
@@ -1,80 +1,118 @@
 #include "QueueDivisionStrategy.h"
 #include "ColorUtils.h"
-#include "IPrintStrategy.h"
+#include "Console.h"
 #include "PrimeUtils.h"
+#include "SearchJob.h"
+#include "SegmentStep.h"
+#include "SinkPolicy.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <iostream>
 #include <thread>
 #include <vector>
 
 // Define static mutex for console output protection.
 std::mutex QueueDivisionStrategy::consoleMutex;
 
-// Find primes using queue division strategy with atomic counter.
-std::vector<int> QueueDivisionStrategy::findPrimes(int upperLimit, int numThreads,
-                                                   std::shared_ptr<IPrintStrategy> printStrategy) {
+// Find primes using queue division strategy with atomic counter on the shared pool.
+Task<PrimeSearchResult> QueueDivisionStrategy::findPrimesAsync(int upperLimit, int numThreads,
+                                                               std::shared_ptr<IPrintStrategy> printStrategy,
+                                                               SearchOptions options) {
+    return findPrimesWith<IPrintStrategy>(upperLimit, numThreads, std::move(printStrategy),
+                                          std::move(options));
+}
+
+// Run the search with a statically typed sink.
+template <typename Sink>
+Task<PrimeSearchResult> QueueDivisionStrategy::findPrimesWith(int upperLimit, int numThreads,
+                                                              std::shared_ptr<Sink> sink,
+                                                              SearchOptions options) {
+    numThreads = std::max(1, numThreads);
     {
         std::lock_guard<std::mutex> lock(consoleMutex);
-        std::cout << ColorUtils::highlight("[QUEUE DIVISION]") << " Finding primes up to "
-                  << ColorUtils::bold(std::to_string(upperLimit)) << " using "
-                  << ColorUtils::bold(std::to_string(numThreads)) << " threads with "
-                  << ColorUtils::info("atomic counter") << std::endl;
+        Console::status() << ColorUtils::highlight("[QUEUE DIVISION]") << " Finding primes up to "
+                          << ColorUtils::bold(std::to_string(upperLimit)) << " using "
+                          << ColorUtils::bold(std::to_string(numThreads)) << " threads with "
+                          << ColorUtils::info("atomic counter") << std::endl;
     }
 
-    std::vector<int> allPrimes;
-    std::vector<std::thread> threads;
-    std::mutex primesMutex;
-    std::atomic<int> counter{2}; // Start from 2 (first prime).
+    auto job = std::make_shared<SearchJob>(sink, std::move(options), numThreads);
+    ThreadPool &pool = ThreadPool::shared();
+    pool.ensureWorkers(numThreads);
+
+    // Threads claim whole segments from the counter so cancellation is checked between segments.
+    // Start from 2 (first prime).
+    auto segments = std::make_shared<const std::vector<Segment>>(
+        SegmentPlanner::split(2, upperLimit, job->options().segmentSize));
+    auto counter = std::make_shared<std::atomic<size_t>>(0);
+
+    // Counting sinks sieve each segment, so they need the primes up to sqrt(upperLimit) once.
+    auto basePrimes = std::make_shared<const std::vector<int>>(
+        CountingSink<Sink> ? PrimeUtils::basePrimesFor(upperLimit) : std::vector<int>{});
+
+    if (job->options().progress) {
+        job->options().progress->setTotals(std::max(0, upperLimit - 1), segments->size());
+    }
 
     for (int i = 0; i < numThreads; ++i) {
-        threads.emplace_back([&counter, upperLimit, printStrategy, &allPrimes, &primesMutex]() {
-            {
-                std::lock_guard<std::mutex> lock(consoleMutex);
-                std::cout << ColorUtils::thread(
-                                 "[THREAD " +
-                                 std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) %
-                                                10000) +
-                                 "]")
-                          << " Starting " << ColorUtils::info("queue-based processing") << std::endl;
-            }
+        pool.submit([worker = i, counter, segments, job, sink, basePrimes]() {
+            try {
+                size_t threadTag = std::hash<std::thread::id>{}(std::this_thread::get_id()) % 10000;
+                std::string threadLabel = ColorUtils::thread("[THREAD " + std::to_string(threadTag) + "]");
+                {
+                    std::lock_guard<std::mutex> lock(consoleMutex);
+                    Console::status() << threadLabel << " Starting "
+                                      << ColorUtils::info("queue-based processing") << std::endl;
+                }
 
-            int threadPrimeCount = 0;
+                size_t threadPrimeCount = 0;
+                std::vector<uint64_t> bits;
 
-            while (true) {
-                int current = counter.fetch_add(1);
-                if (current > upperLimit)
-                    break;
+                while (true) {
+                    size_t current = counter->fetch_add(1);
+                    if (current >= segments->size())
+                        break;
+                    if (job->shouldStop())
+                        break;
 
-                // Check if current number is prime.
-                if (PrimeUtils::isPrime(current)) {
-                    auto timestamp = std::chrono::system_clock::now();
-                    printStrategy->printPrime(current, std::this_thread::get_id(), timestamp);
+                    const Segment &segment = (*segments)[current];
+                    if (!processSegment(*job, *sink, segment, worker, *basePrimes, bits, threadPrimeCount)) {
+                        break;
+                    }
+                }
 
-                    std::lock_guard<std::mutex> lock(primesMutex);
-                    allPrimes.push_back(current);
-                    threadPrimeCount++;
+                {
+                    std::lock_guard<std::mutex> lock(consoleMutex);
+                    Console::status() << threadLabel << " Found "
+                                      << ColorUtils::success(std::to_string(threadPrimeCount)) << " primes"
+                                      << std::endl;
                 }
+            } catch (...) {
+                job->fail(std::current_exception());
             }
 
-            {
-                std::lock_guard<std::mutex> lock(consoleMutex);
-                std::cout << ColorUtils::thread(
-                                 "[THREAD " +
-                                 std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) %
-                                                10000) +
-                                 "]")
-                          << " Found " << ColorUtils::success(std::to_string(threadPrimeCount)) << " primes"
-                          << std::endl;
+            // The last worker to finish finalizes the job.
+            if (job->finishWorker()) {
+                if (job->stopped()) {
+                    std::lock_guard<std::mutex> lock(consoleMutex);
+                    Console::status() << ColorUtils::warning("[QUEUE DIVISION] Stopped early")
+                                      << " - returning "
+                                      << ColorUtils::bold(std::to_string(job->primeCount()))
+                                      << " primes from completed segments" << std::endl;
+                }
+                job->complete();
             }
         });
     }
 
-    // Wait for all threads to complete.
-    for (auto &thread : threads) {
-        thread.join();
-    }
-
-    printStrategy->finalize(allPrimes);
-    return allPrimes;
+    return job->task();
 }
+
+// One instantiation per sink in PRIME_FINDER_SINKS.
+#define INSTANTIATE_FIND_PRIMES_WITH(Sink)                                                                   \
+    template Task<PrimeSearchResult> QueueDivisionStrategy::findPrimesWith<Sink>(int, int,                   \
+                                                                           std::shared_ptr<Sink>,            \
+                                                                           SearchOptions);
+PRIME_FINDER_SINKS(INSTANTIATE_FIND_PRIMES_WITH)
+#undef INSTANTIATE_FIND_PRIMES_WITH
@@ -1,32 +1,59 @@
 #include "RangeDivisionStrategy.h"
 #include "ColorUtils.h"
-#include "IPrintStrategy.h"
+#include "Console.h"
 #include "PrimeUtils.h"
+#include "SearchJob.h"
+#include "SegmentStep.h"
+#include "SinkPolicy.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <chrono>
-#include <iostream>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
 // Define static mutex for console output protection.
 std::mutex RangeDivisionStrategy::consoleMutex;
 
-// Find primes using range division strategy.
-std::vector<int> RangeDivisionStrategy::findPrimes(int upperLimit, int numThreads,
-                                                   std::shared_ptr<IPrintStrategy> printStrategy) {
+// Find primes using range division strategy on the shared pool.
+Task<PrimeSearchResult> RangeDivisionStrategy::findPrimesAsync(int upperLimit, int numThreads,
+                                                               std::shared_ptr<IPrintStrategy> printStrategy,
+                                                               SearchOptions options) {
+    return findPrimesWith<IPrintStrategy>(upperLimit, numThreads, std::move(printStrategy),
+                                          std::move(options));
+}
+
+// Run the search with a statically typed sink.
+template <typename Sink>
+Task<PrimeSearchResult> RangeDivisionStrategy::findPrimesWith(int upperLimit, int numThreads,
+                                                              std::shared_ptr<Sink> sink,
+                                                              SearchOptions options) {
+    // A range worker waiting for its window would hold a pool thread the earlier ranges may need.
+    if constexpr (WindowedSink<Sink>) {
+        throw std::invalid_argument("Ordered print mode needs queue division; range workers would block "
+                                    "the shared pool waiting for earlier ranges");
+    }
+
+    numThreads = std::max(1, numThreads);
     {
         std::lock_guard<std::mutex> lock(consoleMutex);
-        std::cout << ColorUtils::highlight("[RANGE DIVISION]") << " Finding primes up to "
-                  << ColorUtils::bold(std::to_string(upperLimit)) << " using "
-                  << ColorUtils::bold(std::to_string(numThreads)) << " threads" << std::endl;
+        Console::status() << ColorUtils::highlight("[RANGE DIVISION]") << " Finding primes up to "
+                          << ColorUtils::bold(std::to_string(upperLimit)) << " using "
+                          << ColorUtils::bold(std::to_string(numThreads)) << " threads" << std::endl;
     }
 
-    std::vector<int> allPrimes;
-    std::vector<std::thread> threads;
-    std::mutex primesMutex;
+    auto job = std::make_shared<SearchJob>(sink, std::move(options), numThreads);
+    ThreadPool &pool = ThreadPool::shared();
+    pool.ensureWorkers(numThreads);
+
+    // Counting sinks sieve each segment, so they need the primes up to sqrt(upperLimit) once.
+    auto basePrimes = std::make_shared<const std::vector<int>>(
+        CountingSink<Sink> ? PrimeUtils::basePrimesFor(upperLimit) : std::vector<int>{});
 
     // Calculate range per thread.
     int rangePerThread = upperLimit / numThreads;
     int remainder = upperLimit % numThreads;
+    int nextSegmentIndex = 0;
 
     for (int i = 0; i < numThreads; ++i) {
         int start = i * rangePerThread + 1;
@@ -35,52 +62,70 @@ std::vector<int> RangeDivisionStrategy::findPrimes(int upperLimit, int numThread
             end += remainder; // Last thread handles remainder.
         }
 
-        threads.emplace_back([start, end, printStrategy, &allPrimes, &primesMutex]() {
-            {
-                std::lock_guard<std::mutex> lock(consoleMutex);
-                std::cout << ColorUtils::thread(
-                                 "[THREAD " +
-                                 std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) %
-                                                10000) +
-                                 "]")
-                          << " Processing range "
-                          << ColorUtils::warning(std::to_string(start) + "-" + std::to_string(end))
-                          << std::endl;
-            }
+        // Split the thread's range into segments so cancellation is checked regularly.
+        std::vector<Segment> segments =
+            SegmentPlanner::split(start, end, job->options().segmentSize, nextSegmentIndex);
+        nextSegmentIndex += static_cast<int>(segments.size());
+
+        pool.submit([worker = i, start, end, segments = std::move(segments), job, sink, basePrimes]() {
+            try {
+                size_t threadTag = std::hash<std::thread::id>{}(std::this_thread::get_id()) % 10000;
+                std::string threadLabel = ColorUtils::thread("[THREAD " + std::to_string(threadTag) + "]");
+                std::string rangeLabel =
+                    ColorUtils::warning(std::to_string(start) + "-" + std::to_string(end));
+                {
+                    std::lock_guard<std::mutex> lock(consoleMutex);
+                    Console::status() << threadLabel << " Processing range " << rangeLabel << std::endl;
+                }
 
-            // Find all primes in this thread's range.
-            std::vector<int> threadPrimes = PrimeUtils::findPrimesInRange(start, end);
+                size_t threadPrimeCount = 0;
+                std::vector<uint64_t> bits;
 
-            // Report each prime found.
-            for (int prime : threadPrimes) {
-                auto timestamp = std::chrono::system_clock::now();
-                printStrategy->printPrime(prime, std::this_thread::get_id(), timestamp);
+                for (const Segment &segment : segments) {
+                    if (job->shouldStop()) {
+                        break;
+                    }
 
-                // Add to global collection.
-                std::lock_guard<std::mutex> lock(primesMutex);
-                allPrimes.push_back(prime);
+                    if (!processSegment(*job, *sink, segment, worker, *basePrimes, bits, threadPrimeCount)) {
+                        break;
+                    }
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(consoleMutex);
+                    Console::status() << threadLabel << " Found "
+                                      << ColorUtils::success(std::to_string(threadPrimeCount))
+                                      << " primes in range " << rangeLabel << std::endl;
+                }
+            } catch (...) {
+                job->fail(std::current_exception());
             }
 
-            {
-                std::lock_guard<std::mutex> lock(consoleMutex);
-                std::cout << ColorUtils::thread(
-                                 "[THREAD " +
-                                 std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) %
-                                                10000) +
-                                 "]")
-                          << " Found " << ColorUtils::success(std::to_string(threadPrimes.size()))
-                          << " primes in range "
-                          << ColorUtils::warning(std::to_string(start) + "-" + std::to_string(end))
-                          << std::endl;
+            // The last worker to finish finalizes the job.
+            if (job->finishWorker()) {
+                if (job->stopped()) {
+                    std::lock_guard<std::mutex> lock(consoleMutex);
+                    Console::status() << ColorUtils::warning("[RANGE DIVISION] Stopped early")
+                                      << " - returning "
+                                      << ColorUtils::bold(std::to_string(job->primeCount()))
+                                      << " primes from completed segments" << std::endl;
+                }
+                job->complete();
             }
         });
     }
 
-    // Wait for all threads to complete.
-    for (auto &thread : threads) {
-        thread.join();
+    if (job->options().progress) {
+        job->options().progress->setTotals(std::max(0, upperLimit), nextSegmentIndex);
     }
 
-    printStrategy->finalize(allPrimes);
-    return allPrimes;
+    return job->task();
 }
+
+// One instantiation per sink in PRIME_FINDER_SINKS.
+#define INSTANTIATE_FIND_PRIMES_WITH(Sink)                                                                   \
+    template Task<PrimeSearchResult> RangeDivisionStrategy::findPrimesWith<Sink>(int, int,                   \
+                                                                           std::shared_ptr<Sink>,            \
+                                                                           SearchOptions);
+PRIME_FINDER_SINKS(INSTANTIATE_FIND_PRIMES_WITH)
+#undef INSTANTIATE_FIND_PRIMES_WITH
@@ -0,0 +1,117 @@
+#include "ResultSinks.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <stdexcept>
+
+// Count one prime.
+void CountSink::printPrime(int /* prime */, std::thread::id /* threadId */,
+                           std::chrono::system_clock::time_point /* timestamp */) {
+    primeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Count a segment.
+void CountSink::printPrimes(std::span<const int> primes, const SegmentInfo & /* info */) {
+    primeCount.fetch_add(primes.size(), std::memory_order_relaxed);
+}
+
+// Count a segment without its primes.
+void CountSink::addCount(size_t count, const SegmentInfo & /* info */) {
+    primeCount.fetch_add(count, std::memory_order_relaxed);
+}
+
+void CountSink::finalize(const SearchSummary & /* summary */) {}
+
+// Keep one prime.
+void VectorSink::printPrime(int prime, std::thread::id /* threadId */,
+                            std::chrono::system_clock::time_point /* timestamp */) {
+    std::lock_guard<std::mutex> lock(mutex);
+    collected.push_back(prime);
+}
+
+// Keep a segment under one lock.
+void VectorSink::printPrimes(std::span<const int> primes, const SegmentInfo & /* info */) {
+    std::lock_guard<std::mutex> lock(mutex);
+    collected.insert(collected.end(), primes.begin(), primes.end());
+}
+
+// Sort in place; segments arrive in completion order.
+void VectorSink::finalize(const SearchSummary & /* summary */) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::sort(collected.begin(), collected.end());
+}
+
+// Open the output file.
+FileSink::FileSink(const std::string &path) : file(path, std::ios::binary | std::ios::trunc) {
+    if (!file) {
+        throw std::runtime_error("Cannot open output file '" + path + "'");
+    }
+}
+
+// Write one prime.
+void FileSink::printPrime(int prime, std::thread::id threadId,
+                          std::chrono::system_clock::time_point timestamp) {
+    printPrimes(std::span<const int>(&prime, 1), SegmentInfo{{}, 0, threadId, timestamp});
+}
+
+// Format a segment outside the lock, then write it in one call.
+void FileSink::printPrimes(std::span<const int> primes, const SegmentInfo & /* info */) {
+    std::string lines(primes.size() * 12, '\0');
+    char *out = lines.data();
+    for (int prime : primes) {
+        out = std::to_chars(out, lines.data() + lines.size(), prime).ptr;
+        *out++ = '\n';
+    }
+    lines.resize(static_cast<size_t>(out - lines.data()));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file.write(lines.data(), static_cast<std::streamsize>(lines.size()));
+}
+
+// Flush buffered output.
+void FileSink::finalize(const SearchSummary & /* summary */) {
+    std::lock_guard<std::mutex> lock(mutex);
+    file.flush();
+}
+
+// Size the bitmap for the search range.
+BitmapSink::BitmapSink(int upperLimit) : bits(static_cast<size_t>(std::max(0, upperLimit)) / 64 + 1) {}
+
+// Set a prime's bit; neighbouring segments can share a word, so the update is atomic.
+void BitmapSink::mark(int prime) {
+    if (prime < 0 || static_cast<size_t>(prime) / 64 >= bits.size()) {
+        return;
+    }
+    std::atomic_ref<uint64_t> word(bits[static_cast<size_t>(prime) / 64]);
+    word.fetch_or(uint64_t{1} << (prime % 64), std::memory_order_relaxed);
+}
+
+void BitmapSink::printPrime(int prime, std::thread::id /* threadId */,
+                            std::chrono::system_clock::time_point /* timestamp */) {
+    mark(prime);
+}
+
+void BitmapSink::printPrimes(std::span<const int> primes, const SegmentInfo & /* info */) {
+    for (int prime : primes) {
+        mark(prime);
+    }
+}
+
+void BitmapSink::finalize(const SearchSummary & /* summary */) {}
+
+// Test one number.
+bool BitmapSink::contains(int number) const {
+    if (number < 0 || static_cast<size_t>(number) / 64 >= bits.size()) {
+        return false;
+    }
+    return (bits[static_cast<size_t>(number) / 64] >> (number % 64)) & 1;
+}
+
+// Count marked primes.
+size_t BitmapSink::count() const {
+    size_t total = 0;
+    for (uint64_t word : bits) {
+        total += static_cast<size_t>(std::popcount(word));
+    }
+    return total;
+}
@@ -0,0 +1,76 @@
+#include "SearchJob.h"
+#include "IPrintStrategy.h"
+
+// Create a job expecting the given number of workers.
+SearchJob::SearchJob(std::shared_ptr<IPrintStrategy> printStrategy, SearchOptions options, int workers)
+    : sink(std::move(printStrategy)), searchOptions(std::move(options)), remainingWorkers(workers) {}
+
+// Check stop conditions and remember an early stop.
+bool SearchJob::shouldStop() {
+    if (searchOptions.shouldStop()) {
+        wasStopped = true;
+    }
+    return wasStopped;
+}
+
+// Commit a whole segment so partial results stay consistent.
+void SearchJob::commitSegment(int worker, const Segment &segment, const std::vector<int> &primes) {
+    {
+        std::lock_guard<std::mutex> lock(primesMutex);
+        committedPrimes += primes.size();
+        if (searchOptions.collectPrimes) {
+            allPrimes.insert(allPrimes.end(), primes.begin(), primes.end());
+        }
+    }
+
+    if (searchOptions.progress) {
+        searchOptions.progress->recordSegment(worker, static_cast<uint64_t>(segment.end) - segment.start + 1,
+                                              primes.size());
+    }
+}
+
+// Commit a segment's count; there are no primes to keep.
+void SearchJob::commitCount(int worker, const Segment &segment, size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(primesMutex);
+        committedPrimes += count;
+    }
+
+    if (searchOptions.progress) {
+        searchOptions.progress->recordSegment(worker, static_cast<uint64_t>(segment.end) - segment.start + 1,
+                                              count);
+    }
+}
+
+// Keep the first worker failure.
+void SearchJob::fail(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(primesMutex);
+    if (!firstError) {
+        firstError = error;
+    }
+    wasStopped = true; // Let the other workers wind down quickly.
+}
+
+// Count down finished workers.
+bool SearchJob::finishWorker() { return remainingWorkers.fetch_sub(1) == 1; }
+
+// Return the number of primes committed so far.
+size_t SearchJob::primeCount() {
+    std::lock_guard<std::mutex> lock(primesMutex);
+    return committedPrimes;
+}
+
+// Finalize output and publish the result.
+void SearchJob::complete() {
+    if (firstError) {
+        promise.setException(firstError);
+        return;
+    }
+
+    try {
+        sink->finalize(SearchSummary{committedPrimes, !wasStopped});
+        promise.setValue(PrimeSearchResult{std::move(allPrimes), !wasStopped, committedPrimes});
+    } catch (...) {
+        promise.setException(std::current_exception());
+    }
+}
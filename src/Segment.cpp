@@ -0,0 +1,21 @@
+#include "Segment.h"
+#include <algorithm>
+
+// Split an inclusive range into consecutive segments.
+std::vector<Segment> SegmentPlanner::split(int start, int end, int segmentSize, int firstIndex) {
+    std::vector<Segment> segments;
+    if (start > end) {
+        return segments;
+    }
+
+    segmentSize = std::max(1, segmentSize);
+    int index = firstIndex;
+
+    // Use 64-bit arithmetic so ranges ending near INT_MAX do not overflow.
+    for (long long segmentStart = start; segmentStart <= end; segmentStart += segmentSize) {
+        long long segmentEnd = std::min<long long>(end, segmentStart + segmentSize - 1);
+        segments.push_back({index++, static_cast<int>(segmentStart), static_cast<int>(segmentEnd)});
+    }
+
+    return segments;
+}
@@ -0,0 +1,280 @@
+#include "ShardedPrintStrategy.h"
+#include "ColorUtils.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+// Reflected CRC-32 lookup table for polynomial 0xEDB88320.
+constexpr std::array<uint32_t, 256> CRC_TABLE = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320u : 0);
+        }
+        table[i] = crc;
+    }
+    return table;
+}();
+
+// Shard file name; zero-padded bounds keep a directory listing in range order.
+std::string shardName(int start, int end, ShardFormat format) {
+    char name[48];
+    const char *extension = format == ShardFormat::TEXT ? "txt" : "u32";
+    std::snprintf(name, sizeof(name), "primes_%010d_%010d.%s", start, end, extension);
+    return name;
+}
+
+// Encode a shard's primes.
+std::string encodeShard(std::span<const int> primes, ShardFormat format) {
+    std::string data;
+    if (format == ShardFormat::TEXT) {
+        data.resize(primes.size() * 11);
+        char *cursor = data.data();
+        for (int prime : primes) {
+            cursor = std::to_chars(cursor, data.data() + data.size(), prime).ptr;
+            *cursor++ = '\n';
+        }
+        data.resize(static_cast<size_t>(cursor - data.data()));
+        return data;
+    }
+    data.reserve(primes.size() * 4);
+    for (int prime : primes) {
+        auto value = static_cast<uint32_t>(prime);
+        for (int shift = 0; shift < 32; shift += 8) {
+            data += static_cast<char>(value >> shift);
+        }
+    }
+    return data;
+}
+
+// Decode a shard's primes; false when the data is malformed.
+bool decodeShard(std::string_view data, ShardFormat format, std::vector<int> &primes) {
+    if (format == ShardFormat::TEXT) {
+        const char *cursor = data.data();
+        const char *end = data.data() + data.size();
+        while (cursor < end) {
+            int prime = 0;
+            auto [next, error] = std::from_chars(cursor, end, prime);
+            if (error != std::errc() || next == end || *next != '\n') {
+                return false;
+            }
+            primes.push_back(prime);
+            cursor = next + 1;
+        }
+        return true;
+    }
+    if (data.size() % 4 != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < data.size(); i += 4) {
+        uint32_t value = 0;
+        for (int at = 3; at >= 0; --at) {
+            value = value << 8 | static_cast<unsigned char>(data[i + at]);
+        }
+        primes.push_back(static_cast<int>(value));
+    }
+    return true;
+}
+
+// Read a whole file; false when it cannot be opened.
+bool readFile(const std::string &path, std::string &contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+} // namespace
+
+// Prepare the directory and remember what an earlier run left there.
+ShardedPrintStrategy::ShardedPrintStrategy(const std::string &shardDirectory, ShardFormat shardFormat,
+                                           std::shared_ptr<IOutputWriter> statusWriter)
+    : directory(shardDirectory), format(shardFormat), writer(std::move(statusWriter)),
+      lastManifest(std::chrono::steady_clock::now()) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        throw std::runtime_error("Cannot create shard directory '" + directory + "'");
+    }
+    if (!writer) {
+        writer = std::make_shared<FdOutputWriter>(STDOUT_FILENO);
+    }
+
+    // Lines that do not parse are ignored; their shards are simply computed again.
+    std::ifstream manifest(directory + "/" + std::string(MANIFEST_NAME));
+    for (std::string line; std::getline(manifest, line);) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        ShardEntry entry;
+        std::string crc;
+        if (!(fields >> entry.file >> entry.start >> entry.end >> entry.primes >> entry.bytes >> crc)) {
+            continue;
+        }
+        auto [next, error] = std::from_chars(crc.data(), crc.data() + crc.size(), entry.crc, 16);
+        if (error == std::errc() && next == crc.data() + crc.size()) {
+            previous[{entry.start, entry.end}] = entry;
+        }
+    }
+}
+
+// Write one prime as its own shard.
+void ShardedPrintStrategy::printPrime(int prime, std::thread::id threadId,
+                                      std::chrono::system_clock::time_point timestamp) {
+    printPrimes(std::span<const int>(&prime, 1), SegmentInfo{{0, prime, prime}, 0, threadId, timestamp});
+}
+
+// Encode and write the segment's shard from the calling worker.
+void ShardedPrintStrategy::printPrimes(std::span<const int> primes, const SegmentInfo &info) {
+    ShardEntry entry;
+    entry.file = shardName(info.segment.start, info.segment.end, format);
+    entry.start = info.segment.start;
+    entry.end = info.segment.end;
+    entry.primes = primes.size();
+
+    std::string data = encodeShard(primes, format);
+    entry.bytes = data.size();
+    entry.crc = crc32(data);
+    FdOutputWriter::openFile(directory + "/" + entry.file)->write(data);
+    record(std::move(entry));
+}
+
+// Reuse an earlier shard only when the manifest, the file size and the checksum all agree.
+bool ShardedPrintStrategy::restoreShard(const Segment &segment, std::vector<int> &primes) {
+    auto found = previous.find({segment.start, segment.end});
+    if (found == previous.end() || found->second.file != shardName(segment.start, segment.end, format)) {
+        return false;
+    }
+    const ShardEntry &entry = found->second;
+    std::string data;
+    bool valid = readFile(directory + "/" + entry.file, data) && data.size() == entry.bytes &&
+                 crc32(data) == entry.crc && decodeShard(data, format, primes) &&
+                 primes.size() == entry.primes;
+    if (!valid) {
+        primes.clear();
+        return false;
+    }
+    record(entry);
+    ++reused;
+    return true;
+}
+
+// Add a finished shard, and rewrite the manifest when the last rewrite is old enough.
+void ShardedPrintStrategy::record(ShardEntry entry) {
+    std::vector<ShardEntry> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(entriesMutex);
+        entries.push_back(std::move(entry));
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastManifest < MANIFEST_INTERVAL) {
+            return;
+        }
+        lastManifest = now;
+        snapshot = entries;
+    }
+    // Shards of the earlier run not reached yet stay listed, so an interrupted rerun forgets nothing.
+    writeManifest(std::move(snapshot), true);
+}
+
+// Write the manifest under a temporary name, sync it and rename it over the old one.
+void ShardedPrintStrategy::writeManifest(std::vector<ShardEntry> shards, bool keepPrevious) {
+    std::lock_guard<std::mutex> lock(manifestMutex);
+    if (shards.size() < manifestShards) {
+        return; // A newer snapshot is already on disk.
+    }
+    manifestShards = shards.size();
+
+    std::map<std::pair<int, int>, ShardEntry> listed;
+    if (keepPrevious) {
+        listed = previous;
+    }
+    for (ShardEntry &entry : shards) {
+        listed[{entry.start, entry.end}] = std::move(entry);
+    }
+
+    std::string manifest = "# file\tstart\tend\tprimes\tbytes\tcrc32\n";
+    for (const auto &[range, entry] : listed) {
+        char crc[9];
+        std::snprintf(crc, sizeof(crc), "%08x", entry.crc);
+        manifest += entry.file + "\t" + std::to_string(entry.start) + "\t" + std::to_string(entry.end) + "\t";
+        manifest += std::to_string(entry.primes) + "\t" + std::to_string(entry.bytes) + "\t" + crc + "\n";
+    }
+
+    std::string path = directory + "/" + std::string(MANIFEST_NAME);
+    std::string tmpPath = path + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot write shard manifest '" + path + "'");
+    }
+    try {
+        FdOutputWriter(fd).write(manifest);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    std::error_code error;
+    if (synced) {
+        std::filesystem::rename(tmpPath, path, error);
+    }
+    if (!synced || error) {
+        throw std::runtime_error("Cannot write shard manifest '" + path + "'");
+    }
+}
+
+// Write the final manifest and the summary line.
+void ShardedPrintStrategy::finalize(const SearchSummary &summary) {
+    std::vector<ShardEntry> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(entriesMutex);
+        snapshot = entries;
+    }
+    // A complete run lists exactly its own shards; a stopped one keeps the earlier run's as well.
+    writeManifest(snapshot, !summary.complete);
+
+    std::string path = directory + "/" + std::string(MANIFEST_NAME);
+    size_t written = snapshot.size() - reused;
+    std::string line = ColorUtils::info("[SHARDED]") + " Wrote " + std::to_string(written) +
+                       " shards, reused " + std::to_string(reused) + ", " +
+                       ColorUtils::bold(std::to_string(summary.primeCount)) + " primes, manifest " + path;
+    if (!summary.complete) {
+        line += " " + ColorUtils::warning("(stopped early)");
+    }
+    writer->write(line + "\n");
+    writer->flush();
+}
+
+// Parse a shard format name.
+ShardFormat ShardedPrintStrategy::parseFormat(const std::string &name) {
+    if (name == "text") {
+        return ShardFormat::TEXT;
+    }
+    if (name == "u32") {
+        return ShardFormat::U32;
+    }
+    throw std::invalid_argument("Invalid shard format: " + name);
+}
+
+// Table-driven CRC-32.
+uint32_t ShardedPrintStrategy::crc32(std::string_view data) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (char c : data) {
+        crc = CRC_TABLE[(crc ^ static_cast<unsigned char>(c)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
@@ -0,0 +1,198 @@
+#include "StructuredPrintStrategy.h"
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view NDJSON_PRIME_PREFIX = "{\"type\":\"prime\",\"worker\":";
+constexpr std::string_view NDJSON_PRIME_VALUE = ",\"value\":";
+constexpr std::string_view NDJSON_PRIME_SUFFIX = "}\n";
+constexpr std::string_view CSV_PRIME_PREFIX = "prime,";
+constexpr size_t MAX_DIGITS = 11;
+
+// Append a number with to_chars.
+template <typename T> void appendNumber(std::string &out, T value) {
+    char digits[32];
+    char *end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    out.append(digits, end);
+}
+
+// Append milliseconds with three decimals.
+void appendMilliseconds(std::string &out, double value) {
+    char digits[32];
+    char *end = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 3).ptr;
+    out.append(digits, end);
+}
+
+// Append a JSON string literal.
+void appendJsonString(std::string &out, std::string_view text) {
+    out.push_back('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            constexpr char HEX[] = "0123456789abcdef";
+            out.append("\\u00");
+            out.push_back(HEX[(c >> 4) & 0xF]);
+            out.push_back(HEX[c & 0xF]);
+        } else {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+// Append a CSV field, quoting it when it holds a separator, quote or line break.
+void appendCsvField(std::string &out, std::string_view text) {
+    if (text.find_first_of(",\"\n\r") == std::string_view::npos) {
+        out.append(text);
+        return;
+    }
+    out.push_back('"');
+    for (char c : text) {
+        if (c == '"') {
+            out.push_back('"');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+} // namespace
+
+// Remember the run settings; CSV starts with its header.
+StructuredPrintStrategy::StructuredPrintStrategy(std::shared_ptr<IOutputWriter> outputWriter,
+                                                 StructuredFormat outputFormat, Config config)
+    : writer(std::move(outputWriter)), format(outputFormat), runConfig(std::move(config)),
+      started(std::chrono::steady_clock::now()) {
+    if (format == StructuredFormat::CSV) {
+        writer->write("record,key,value\n");
+    }
+}
+
+// Write one prime as its own batch.
+void StructuredPrintStrategy::printPrime(int prime, std::thread::id threadId,
+                                         std::chrono::system_clock::time_point timestamp) {
+    printPrimes(std::span<const int>(&prime, 1), SegmentInfo{{}, 0, threadId, timestamp});
+}
+
+// Format the segment's records into this thread's buffer and write them in one call.
+void StructuredPrintStrategy::printPrimes(std::span<const int> primes, const SegmentInfo &info) {
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        if (workers.size() <= static_cast<size_t>(info.worker)) {
+            workers.resize(static_cast<size_t>(info.worker) + 1);
+        }
+        WorkerStats &stats = workers[static_cast<size_t>(info.worker)];
+        stats.primes += primes.size();
+        stats.segments += 1;
+        stats.candidates += static_cast<uint64_t>(info.segment.end - info.segment.start) + 1;
+    }
+    if (primes.empty()) {
+        return;
+    }
+
+    // The worker prefix is the same for every record of the segment, so it is formatted once.
+    char workerDigits[MAX_DIGITS];
+    char *workerEnd = std::to_chars(workerDigits, workerDigits + MAX_DIGITS, info.worker).ptr;
+    std::string_view worker(workerDigits, static_cast<size_t>(workerEnd - workerDigits));
+
+    thread_local std::string buffer;
+    buffer.clear();
+    size_t recordSize =
+        format == StructuredFormat::NDJSON
+            ? NDJSON_PRIME_PREFIX.size() + NDJSON_PRIME_VALUE.size() + NDJSON_PRIME_SUFFIX.size()
+            : CSV_PRIME_PREFIX.size() + 2;
+    buffer.resize(primes.size() * (recordSize + worker.size() + MAX_DIGITS));
+    char *out = buffer.data();
+    char *limit = buffer.data() + buffer.size();
+    for (int prime : primes) {
+        if (format == StructuredFormat::NDJSON) {
+            out = std::copy(NDJSON_PRIME_PREFIX.begin(), NDJSON_PRIME_PREFIX.end(), out);
+            out = std::copy(worker.begin(), worker.end(), out);
+            out = std::copy(NDJSON_PRIME_VALUE.begin(), NDJSON_PRIME_VALUE.end(), out);
+            out = std::to_chars(out, limit, prime).ptr;
+            out = std::copy(NDJSON_PRIME_SUFFIX.begin(), NDJSON_PRIME_SUFFIX.end(), out);
+        } else {
+            out = std::copy(CSV_PRIME_PREFIX.begin(), CSV_PRIME_PREFIX.end(), out);
+            out = std::copy(worker.begin(), worker.end(), out);
+            *out++ = ',';
+            out = std::to_chars(out, limit, prime).ptr;
+            *out++ = '\n';
+        }
+    }
+    writer->write(std::string_view(buffer.data(), static_cast<size_t>(out - buffer.data())));
+}
+
+// Write the summary records after all primes.
+void StructuredPrintStrategy::finalize(const SearchSummary &summary) {
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started);
+    std::lock_guard<std::mutex> lock(statsMutex);
+    writer->write(summaryRecords(summary, elapsed.count()));
+    writer->flush();
+}
+
+// Render totals, timings, configuration and worker statistics in the output format.
+std::string StructuredPrintStrategy::summaryRecords(const SearchSummary &summary, double elapsedMs) const {
+    std::string out;
+    if (format == StructuredFormat::NDJSON) {
+        out += "{\"type\":\"summary\",\"primes\":";
+        appendNumber(out, summary.primeCount);
+        out += summary.complete ? ",\"complete\":true" : ",\"complete\":false";
+        out += ",\"elapsed_ms\":";
+        appendMilliseconds(out, elapsedMs);
+        out += ",\"config\":{\"upper_limit\":";
+        appendNumber(out, runConfig.upperLimit);
+        out += ",\"threads\":";
+        appendNumber(out, runConfig.threads);
+        out += ",\"print_mode\":";
+        appendJsonString(out, runConfig.printMode);
+        out += ",\"division_mode\":";
+        appendJsonString(out, runConfig.divisionMode);
+        out += "},\"workers\":[";
+        for (size_t i = 0; i < workers.size(); ++i) {
+            out += i == 0 ? "{\"worker\":" : ",{\"worker\":";
+            appendNumber(out, i);
+            out += ",\"primes\":";
+            appendNumber(out, workers[i].primes);
+            out += ",\"segments\":";
+            appendNumber(out, workers[i].segments);
+            out += ",\"candidates\":";
+            appendNumber(out, workers[i].candidates);
+            out += "}";
+        }
+        out += "]}\n";
+        return out;
+    }
+
+    out += "summary,primes,";
+    appendNumber(out, summary.primeCount);
+    out += summary.complete ? "\nsummary,complete,true\n" : "\nsummary,complete,false\n";
+    out += "summary,elapsed_ms,";
+    appendMilliseconds(out, elapsedMs);
+    out += "\nconfig,upper_limit,";
+    appendNumber(out, runConfig.upperLimit);
+    out += "\nconfig,threads,";
+    appendNumber(out, runConfig.threads);
+    out += "\nconfig,print_mode,";
+    appendCsvField(out, runConfig.printMode);
+    out += "\nconfig,division_mode,";
+    appendCsvField(out, runConfig.divisionMode);
+    out += "\n";
+    for (size_t i = 0; i < workers.size(); ++i) {
+        for (auto [key, value] : {std::pair<const char *, uint64_t>{"primes", workers[i].primes},
+                                  {"segments", workers[i].segments},
+                                  {"candidates", workers[i].candidates}}) {
+            out += "worker_";
+            out += key;
+            out += ",";
+            appendNumber(out, i);
+            out += ",";
+            appendNumber(out, value);
+            out += "\n";
+        }
+    }
+    return out;
+}
@@ -0,0 +1,63 @@
+#include "ThreadPool.h"
+
+// Start the pool with an initial number of workers.
+ThreadPool::ThreadPool(size_t workers) { ensureWorkers(workers); }
+
+// Drain remaining tasks and join all workers.
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+// Return the process-wide pool.
+ThreadPool &ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+// Add workers until the pool has at least the requested size.
+void ThreadPool::ensureWorkers(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    while (workers.size() < count) {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+// Queue a task for the next idle worker.
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+// Return the current number of workers.
+size_t ThreadPool::workerCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return workers.size();
+}
+
+// Run queued tasks until the pool is destroyed.
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return; // Stopping and fully drained.
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,213 @@
+#include "ThreadUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <sched.h>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// Read the first line of a file, or an empty string if it cannot be opened.
+std::string readFirstLine(const std::string &path) {
+    std::ifstream file(path);
+    std::string line;
+    if (file.is_open()) {
+        std::getline(file, line);
+    }
+    return line;
+}
+
+// Return the cgroup path of this process for a v1 controller, or for v2 when controller is empty.
+std::optional<std::string> cgroupPathFor(const std::string &controller) {
+    std::ifstream file("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(file, line)) {
+        // Lines look like "<id>:<controllers>:<path>".
+        size_t first = line.find(':');
+        size_t second = line.find(':', first + 1);
+        if (first == std::string::npos || second == std::string::npos) {
+            continue;
+        }
+
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        std::string path = line.substr(second + 1);
+        if (controller.empty()) {
+            if (controllers.empty()) {
+                return path;
+            }
+            continue;
+        }
+
+        std::stringstream ss(controllers);
+        std::string name;
+        while (std::getline(ss, name, ',')) {
+            if (name == controller) {
+                return path;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+// Pick a thread count from affinity, cgroup quota and SMT topology.
+ThreadCountDecision ThreadUtils::detectThreadCount() {
+    std::vector<int> cpus = readAffinityCpus();
+    int count = static_cast<int>(cpus.size());
+
+    // One thread per physical core the affinity mask reaches.
+    int cores = std::max(1, readCoreCount(cpus));
+    ThreadCountDecision decision{cores, std::format("{} CPUs in affinity mask", count)};
+    if (cores < count) {
+        decision.reason += std::format(" on {} cores (SMT siblings)", cores);
+    }
+
+    // A CPU quota caps usable parallelism no matter how many CPUs are visible.
+    std::string source;
+    if (auto quota = readCgroupCpuQuota(source)) {
+        int quotaThreads = std::max(1, static_cast<int>(std::ceil(*quota)));
+        decision.reason += std::format(", {} quota {:.2f} CPUs", source, *quota);
+        if (quotaThreads < decision.threads) {
+            decision.threads = quotaThreads;
+            decision.reason += " (limiting)";
+        }
+    } else {
+        decision.reason += ", no cgroup CPU quota";
+    }
+
+    return decision;
+}
+
+// Parse cgroup v2 cpu.max contents.
+std::optional<double> ThreadUtils::parseCgroupV2CpuMax(const std::string &contents) {
+    std::stringstream ss(contents);
+    std::string quota;
+    std::string period;
+    if (!(ss >> quota) || quota == "max") {
+        return std::nullopt;
+    }
+    if (!(ss >> period)) {
+        period = "100000"; // Kernel default period when only the quota is given.
+    }
+    return parseCgroupV1Quota(quota, period);
+}
+
+// Parse cgroup v1 CFS quota and period contents.
+std::optional<double> ThreadUtils::parseCgroupV1Quota(const std::string &quota, const std::string &period) {
+    try {
+        long long quotaUs = std::stoll(quota);
+        long long periodUs = std::stoll(period);
+        if (quotaUs <= 0 || periodUs <= 0) {
+            return std::nullopt;
+        }
+        return static_cast<double>(quotaUs) / static_cast<double>(periodUs);
+    } catch (const std::exception &) {
+        return std::nullopt;
+    }
+}
+
+// Count CPUs in a kernel CPU list.
+int ThreadUtils::parseCpuListCount(const std::string &list) {
+    std::stringstream ss(list);
+    std::string item;
+    int count = 0;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        try {
+            size_t dash = item.find('-');
+            if (dash == std::string::npos) {
+                std::stoi(item);
+                count += 1;
+            } else {
+                int low = std::stoi(item.substr(0, dash));
+                int high = std::stoi(item.substr(dash + 1));
+                if (high < low) {
+                    return 0;
+                }
+                count += high - low + 1;
+            }
+        } catch (const std::exception &) {
+            return 0;
+        }
+    }
+    return count;
+}
+
+// Count distinct sibling lists; CPUs without one are separate cores.
+int ThreadUtils::countDistinctCores(const std::vector<std::string> &siblingLists) {
+    std::set<std::string> cores;
+    int unknown = 0;
+    for (const std::string &list : siblingLists) {
+        if (list.empty()) {
+            ++unknown;
+        } else {
+            cores.insert(list);
+        }
+    }
+    return static_cast<int>(cores.size()) + unknown;
+}
+
+// Read the CPU quota of this process from cgroup v2, falling back to cgroup v1.
+std::optional<double> ThreadUtils::readCgroupCpuQuota(std::string &source) {
+    if (auto path = cgroupPathFor("")) {
+        for (const std::string &dir : {"/sys/fs/cgroup" + *path, std::string("/sys/fs/cgroup")}) {
+            std::string contents = readFirstLine(dir + "/cpu.max");
+            if (!contents.empty()) {
+                source = "cgroup v2";
+                return parseCgroupV2CpuMax(contents);
+            }
+        }
+    }
+
+    if (auto path = cgroupPathFor("cpu")) {
+        const std::string mounts[] = {"/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct"};
+        for (const std::string &mount : mounts) {
+            for (const std::string &dir : {mount + *path, mount}) {
+                std::string quota = readFirstLine(dir + "/cpu.cfs_quota_us");
+                std::string period = readFirstLine(dir + "/cpu.cfs_period_us");
+                if (!quota.empty() && !period.empty()) {
+                    source = "cgroup v1";
+                    return parseCgroupV1Quota(quota, period);
+                }
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+// List the CPUs this process is allowed to run on.
+std::vector<int> ThreadUtils::readAffinityCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    if (cpus.empty()) {
+        for (int cpu = 0; cpu < static_cast<int>(std::max(1u, std::thread::hardware_concurrency())); ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// Count the physical cores behind the given CPUs from their SMT sibling lists.
+int ThreadUtils::readCoreCount(const std::vector<int> &cpus) {
+    std::vector<std::string> siblingLists;
+    for (int cpu : cpus) {
+        siblingLists.push_back(
+            readFirstLine(std::format("/sys/devices/system/cpu/cpu{}/topology/thread_siblings_list", cpu)));
+    }
+    return countDistinctCores(siblingLists);
+}
@@ -0,0 +1,422 @@
+#include "UringOutputWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+class UringOutputWriter::Backend {
+public:
+    // One write: a buffer's bytes, where they go, and which buffer to hand back when done.
+    struct WriteRequest {
+        size_t buffer = 0;
+        const char *data = nullptr;
+        size_t size = 0;
+        off_t offset = -1; // -1 writes at the descriptor's current position
+    };
+
+    virtual ~Backend() = default;
+    virtual void submit(const WriteRequest &request) = 0;
+
+    /**
+     * Wait for a write to finish completely and return its buffer; throws std::runtime_error on failure
+     */
+    virtual size_t waitOne() = 0;
+
+    /**
+     * Like waitOne, but return false instead of waiting when no write has finished yet
+     */
+    virtual bool pollOne(size_t &buffer) = 0;
+};
+
+namespace {
+
+// io_uring driven through raw syscalls; this writer is the only submitter and reaper.
+class UringBackend : public UringOutputWriter::Backend {
+public:
+    UringBackend(int outputFd, unsigned entries) : fd(outputFd) {
+        io_uring_params params{};
+        ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ringFd < 0) {
+            throw std::runtime_error("io_uring unavailable");
+        }
+        try {
+            requireWriteOp();
+            mapRings(params);
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~UringBackend() override { release(); }
+
+    void submit(const WriteRequest &request) override {
+        if (pending.size() <= request.buffer) {
+            pending.resize(request.buffer + 1);
+        }
+        pending[request.buffer] = request;
+        push(request);
+    }
+
+    size_t waitOne() override {
+        size_t buffer;
+        while (!pollOne(buffer)) {
+            enter(0, 1, IORING_ENTER_GETEVENTS);
+        }
+        return buffer;
+    }
+
+    bool pollOne(size_t &buffer) override {
+        while (true) {
+            unsigned head = *cqHead;
+            if (head == std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire)) {
+                return false;
+            }
+            io_uring_cqe cqe = cqes[head & cqMask];
+            std::atomic_ref<unsigned>(*cqHead).store(head + 1, std::memory_order_release);
+
+            WriteRequest &request = pending[cqe.user_data];
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                push(request);
+                continue;
+            }
+            if (cqe.res <= 0) {
+                throw std::runtime_error("Failed to write output");
+            }
+            // Resubmit the rest of a short write.
+            size_t done = static_cast<size_t>(cqe.res);
+            request.data += done;
+            request.size -= done;
+            if (request.offset >= 0) {
+                request.offset += static_cast<off_t>(done);
+            }
+            if (request.size > 0) {
+                push(request);
+                continue;
+            }
+            buffer = request.buffer;
+            return true;
+        }
+    }
+
+private:
+    // IORING_OP_WRITE and IORING_REGISTER_PROBE both arrived in Linux 5.6; earlier rings set up fine but
+    // fail every write with -EINVAL, so they count as unavailable.
+    void requireWriteOp() {
+        constexpr unsigned probeOps = IORING_OP_WRITE + 1;
+        std::vector<char> storage(sizeof(io_uring_probe) + probeOps * sizeof(io_uring_probe_op));
+        auto *probe = reinterpret_cast<io_uring_probe *>(storage.data());
+        bool probed = ::syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, probeOps) == 0;
+        if (!probed || probe->last_op < IORING_OP_WRITE ||
+            !(probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED)) {
+            throw std::runtime_error("io_uring unavailable");
+        }
+    }
+
+    void mapRings(const io_uring_params &params) {
+        // Map the submission ring, the completion ring (shared with it on current kernels) and the SQEs.
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMmap) {
+            sqSize = cqSize = std::max(sqSize, cqSize);
+        }
+        sqRing = map(sqSize, IORING_OFF_SQ_RING);
+        cqRing = singleMmap ? sqRing : map(cqSize, IORING_OFF_CQ_RING);
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe *>(map(sqesSize, IORING_OFF_SQES));
+
+        char *sq = static_cast<char *>(sqRing);
+        sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        char *cq = static_cast<char *>(cqRing);
+        cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    }
+
+    void release() {
+        if (sqes) {
+            ::munmap(sqes, sqesSize);
+        }
+        if (cqRing && cqRing != sqRing) {
+            ::munmap(cqRing, cqSize);
+        }
+        if (sqRing) {
+            ::munmap(sqRing, sqSize);
+        }
+        ::close(ringFd);
+    }
+
+    void *map(size_t size, off_t offset) {
+        void *ring = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+        if (ring == MAP_FAILED) {
+            throw std::runtime_error("io_uring unavailable");
+        }
+        return ring;
+    }
+
+    void push(const WriteRequest &request) {
+        unsigned tail = *sqTail;
+        unsigned index = tail & sqMask;
+        io_uring_sqe &sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(request.data);
+        sqe.len = static_cast<uint32_t>(std::min<size_t>(request.size, 1u << 30));
+        sqe.off = request.offset >= 0 ? static_cast<uint64_t>(request.offset) : ~0ULL;
+        sqe.user_data = request.buffer;
+        sqArray[index] = index;
+        std::atomic_ref<unsigned>(*sqTail).store(tail + 1, std::memory_order_release);
+        enter(1, 0, 0);
+    }
+
+    void enter(unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        while (::syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0) < 0) {
+            if (errno != EINTR) {
+                throw std::runtime_error("Failed to write output");
+            }
+        }
+    }
+
+    int fd;
+    int ringFd = -1;
+    void *sqRing = nullptr;
+    void *cqRing = nullptr;
+    size_t sqSize = 0;
+    size_t cqSize = 0;
+    io_uring_sqe *sqes = nullptr;
+    size_t sqesSize = 0;
+    unsigned *sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned *sqArray = nullptr;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe *cqes = nullptr;
+    std::vector<WriteRequest> pending; // Indexed by buffer
+};
+
+// A helper thread writing submitted buffers in order with pwrite(2), or write(2) when it cannot seek.
+class ThreadBackend : public UringOutputWriter::Backend {
+public:
+    explicit ThreadBackend(int outputFd)
+        : fd(outputFd), worker([this](std::stop_token stop) { run(stop); }) {}
+
+    void submit(const WriteRequest &request) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued.push_back(request);
+        }
+        changed.notify_all();
+    }
+
+    size_t waitOne() override {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return !done.empty() || failed; });
+        if (failed) {
+            throw std::runtime_error("Failed to write output");
+        }
+        size_t buffer = done.front();
+        done.pop_front();
+        return buffer;
+    }
+
+    bool pollOne(size_t &buffer) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failed) {
+            throw std::runtime_error("Failed to write output");
+        }
+        if (done.empty()) {
+            return false;
+        }
+        buffer = done.front();
+        done.pop_front();
+        return true;
+    }
+
+private:
+    void run(std::stop_token stop) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (changed.wait(lock, stop, [this] { return !queued.empty(); })) {
+            WriteRequest request = queued.front();
+            queued.pop_front();
+            lock.unlock();
+            bool ok = writeAll(request);
+            lock.lock();
+            if (ok) {
+                done.push_back(request.buffer);
+            } else {
+                failed = true;
+            }
+            changed.notify_all();
+        }
+    }
+
+    bool writeAll(WriteRequest request) const {
+        while (request.size > 0) {
+            ssize_t result = request.offset >= 0 ? ::pwrite(fd, request.data, request.size, request.offset)
+                                                 : ::write(fd, request.data, request.size);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            request.data += result;
+            request.size -= static_cast<size_t>(result);
+            if (request.offset >= 0) {
+                request.offset += result;
+            }
+        }
+        return true;
+    }
+
+    int fd;
+    std::mutex mutex;
+    std::condition_variable_any changed;
+    std::deque<WriteRequest> queued;
+    std::deque<size_t> done;
+    bool failed = false;
+    std::jthread worker; // Declared last so it stops before the queues go away
+};
+
+} // namespace
+
+// Set up the buffers and the ring, falling back to the helper thread.
+UringOutputWriter::UringOutputWriter(int outputFd, size_t bytes, unsigned queueDepth, bool useUring)
+    : fd(outputFd), bufferBytes(std::max<size_t>(bytes, 1)), maxInFlight(std::max(queueDepth, 1u)) {
+    // Regular files take positioned writes, so several can be in flight without reordering bytes.
+    struct stat info {};
+    off_t position = ::lseek(fd, 0, SEEK_CUR);
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && position >= 0) {
+        nextOffset = position;
+    } else {
+        maxInFlight = 1;
+    }
+
+    buffers.resize(maxInFlight + 1);
+    for (size_t i = buffers.size() - 1; i > 0; --i) {
+        freeBuffers.push_back(i);
+    }
+    buffers[filling].reserve(bufferBytes);
+
+    if (useUring) {
+        try {
+            backend = std::make_unique<UringBackend>(fd, maxInFlight);
+            uring = true;
+        } catch (const std::runtime_error &) {
+            // No io_uring here (old kernel, seccomp or disabled); use the thread instead.
+        }
+    }
+    if (!backend) {
+        backend = std::make_unique<ThreadBackend>(fd);
+    }
+}
+
+// Finish every write, then close the descriptor if this writer opened it.
+UringOutputWriter::~UringOutputWriter() {
+    try {
+        flush();
+    } catch (...) {
+        // Nothing sensible to do about a failed write during destruction.
+    }
+    backend.reset();
+    if (ownsFd) {
+        ::close(fd);
+    }
+}
+
+// Open a file for writing and hand its descriptor to a new writer.
+std::shared_ptr<UringOutputWriter> UringOutputWriter::openFile(const std::string &path) {
+    int fileFd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileFd < 0) {
+        throw std::runtime_error("Cannot open output file '" + path + "'");
+    }
+    auto writer = std::make_shared<UringOutputWriter>(fileFd);
+    writer->ownsFd = true;
+    return writer;
+}
+
+// Append to the filling buffer and submit it once it is full or nothing else is being written.
+void UringOutputWriter::write(std::string_view lines) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (failed) {
+        throw std::runtime_error("Failed to write output");
+    }
+    buffers[filling].append(lines);
+
+    // Take back finished buffers. An idle writer then sends at once, so a pipe reader is never left
+    // waiting for a full buffer; blocks arriving while a write is in flight are batched behind it.
+    while (inFlight > 0 && reapOne(false)) {
+        continue;
+    }
+    if (buffers[filling].size() >= bufferBytes || inFlight == 0) {
+        submitFilling();
+    }
+}
+
+// Submit the filling buffer and wait for every write in flight.
+void UringOutputWriter::flush() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (failed) {
+        throw std::runtime_error("Failed to write output");
+    }
+    submitFilling();
+    while (inFlight > 0) {
+        reapOne(true);
+    }
+}
+
+// Hand the filling buffer to the backend and take a free one, waiting for one if all are busy.
+void UringOutputWriter::submitFilling() {
+    std::string &buffer = buffers[filling];
+    if (buffer.empty()) {
+        return;
+    }
+    while (inFlight >= maxInFlight) {
+        reapOne(true);
+    }
+
+    backend->submit(Backend::WriteRequest{filling, buffer.data(), buffer.size(), nextOffset});
+    if (nextOffset >= 0) {
+        nextOffset += static_cast<off_t>(buffer.size());
+    }
+    ++inFlight;
+    filling = freeBuffers.back();
+    freeBuffers.pop_back();
+    buffers[filling].reserve(bufferBytes);
+}
+
+// Take back one finished buffer, waiting for it when wait is set; false when none has finished.
+bool UringOutputWriter::reapOne(bool wait) {
+    size_t buffer;
+    try {
+        if (wait) {
+            buffer = backend->waitOne();
+        } else if (!backend->pollOne(buffer)) {
+            return false;
+        }
+    } catch (...) {
+        failed = true;
+        throw;
+    }
+    --inFlight;
+    written += buffers[buffer].size();
+    buffers[buffer].clear();
+    freeBuffers.push_back(buffer);
+    return true;
+}
@@ -1,53 +1,260 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <csignal>
 #include <format>
+#include <fstream>
 #include <iostream>
+#include <thread>
 
+#include "AsyncOutputWriter.h"
+#include "BatchPlanner.h"
+#include "ClusterWorker.h"
 #include "ColorUtils.h"
+#include "Console.h"
 #include "ConfigParser.h"
 #include "IPrintStrategy.h"
 #include "ITaskDivisionStrategy.h"
+#include "IntervalQueryEngine.h"
+#include "PrimeCache.h"
 #include "PrimeFinderFactory.h"
+#include "PrimeServer.h"
+#include "ProgressReporter.h"
+#include "ProgressTracker.h"
+#include "UringOutputWriter.h"
 
 // Print timestamp with label.
 void printTimestamp(const std::string &label) {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
-    std::cout << ColorUtils::bold("[" + label + "]") << " "
-              << ColorUtils::timestamp(
-                     std::format("{:%a %b %d %H:%M:%S %Y}", std::chrono::system_clock::from_time_t(time_t)))
+    std::string when = std::format("{:%a %b %d %H:%M:%S %Y}", std::chrono::system_clock::from_time_t(time_t));
+    Console::status() << ColorUtils::bold("[" + label + "]") << " " << ColorUtils::timestamp(when)
+                      << std::endl;
+}
+
+// Serve a cluster coordinator as a worker: --worker host:port [connections].
+int runWorker(int argc, char *argv[]) {
+    std::string host;
+    int port = 0;
+    if (argc < 3 || !ClusterWorker::parseAddress(argv[2], host, port)) {
+        std::cerr << ColorUtils::error("Usage: prime_finder --worker host:port [connections]") << std::endl;
+        return 1;
+    }
+
+    int connections = 1;
+    try {
+        connections = argc > 3 ? std::stoi(argv[3]) : 1;
+    } catch (const std::exception &) {
+        std::cerr << ColorUtils::error("Invalid connection count: " + std::string(argv[3])) << std::endl;
+        return 1;
+    }
+
+    std::cout << ColorUtils::info("[WORKER]") << " Connecting to " << ColorUtils::bold(argv[2]) << " with "
+              << ColorUtils::bold(std::to_string(connections)) << " connection(s)" << std::endl;
+    long processed = ClusterWorker::run(host, port, connections);
+    if (processed < 0) {
+        std::cerr << ColorUtils::error("Could not connect to coordinator at " + std::string(argv[2]))
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << ColorUtils::success("[WORKER] Processed " + std::to_string(processed) + " segments")
               << std::endl;
+    return 0;
 }
 
-int main() {
-    printTimestamp("PROGRAM START");
+// Set by SIGINT/SIGTERM to shut the query daemon down.
+std::atomic<bool> serverInterrupted{false};
+
+// Answer queries from a warm cache until interrupted: --serve [socket path].
+int runServer(int argc, char *argv[]) {
+    std::string path = argc > 2 ? argv[2] : PrimeServer::DEFAULT_SOCKET_PATH;
+    Config config = ConfigParser::parseConfig("config.toml");
+
+    // Warm the pool and the cache up front so the first queries are as fast as the rest.
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool::shared().ensureWorkers(config.threads);
+    PrimeCache cache(ThreadPool::shared(), std::max(config.cacheLimit, config.upperLimit));
+    cache.ensure(config.upperLimit);
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    PrimeServer server(cache);
+    if (!server.listen(path)) {
+        std::cerr << ColorUtils::error("Could not listen on " + path) << std::endl;
+        return 1;
+    }
+    std::cout << ColorUtils::info("[SERVER]") << " Cached primes up to "
+              << ColorUtils::bold(std::to_string(cache.limit())) << " in " << elapsed.count()
+              << "ms, listening on " << ColorUtils::highlight(path) << std::endl;
+
+    std::signal(SIGINT, [](int) { serverInterrupted = true; });
+    std::signal(SIGTERM, [](int) { serverInterrupted = true; });
+    std::jthread serverThread([&server](std::stop_token stop) { server.run(stop); });
+    while (!serverInterrupted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    serverThread.request_stop();
+    serverThread.join();
+
+    std::string served = std::to_string(server.requestsServed());
+    std::cout << std::endl << ColorUtils::success("[SERVER] Served " + served + " requests") << std::endl;
+    return 0;
+}
+
+// Answer a file of range queries with one sieve pass: --batch [file|-].
+int runBatch(int argc, char *argv[]) {
+    std::string path = argc > 2 ? argv[2] : "-";
+    Config config = ConfigParser::parseConfig("config.toml");
+
+    try {
+        std::ifstream file;
+        if (path != "-") {
+            file.open(path);
+            if (!file) {
+                std::cerr << ColorUtils::error("Cannot open batch file " + path) << std::endl;
+                return 1;
+            }
+        }
+        std::vector<BatchQuery> queries = BatchPlanner::parse(path == "-" ? std::cin : file);
+
+        BatchPlan plan = BatchPlanner::plan(queries, SegmentPlanner::DEFAULT_SEGMENT_SIZE);
+        std::vector<int> primes = BatchPlanner::execute(plan, config.threads);
+        BatchPlanner::writeResults(queries, primes, std::cout);
 
-    std::cout << ColorUtils::bold("=== ") << ColorUtils::highlight("Prime Number Finder")
-              << ColorUtils::bold(" ===") << std::endl;
+        // Diagnostics go to stderr so stdout stays parseable.
+        std::cerr << ColorUtils::info("[BATCH]") << " " << queries.size() << " queries, "
+                  << plan.ranges.size() << " merged ranges, sieved " << plan.sieved << " of "
+                  << plan.requested << " requested numbers" << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << ColorUtils::error("Error: " + std::string(e.what())) << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Answer count/list interval queries offline with one sweep: --queries [file|-].
+int runQueries(int argc, char *argv[]) {
+    std::string path = argc > 2 ? argv[2] : "-";
+    Config config = ConfigParser::parseConfig("config.toml");
+
+    try {
+        std::ifstream file;
+        if (path != "-") {
+            file.open(path);
+            if (!file) {
+                std::cerr << ColorUtils::error("Cannot open query file " + path) << std::endl;
+                return 1;
+            }
+        }
+        std::vector<IntervalQuery> queries = IntervalQueryEngine::parse(path == "-" ? std::cin : file);
+        auto answers = IntervalQueryEngine::answer(queries, config.threads);
+        IntervalQueryEngine::write(queries, answers, std::cout);
+    } catch (const std::exception &e) {
+        std::cerr << ColorUtils::error("Error: " + std::string(e.what())) << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--worker") {
+        return runWorker(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--serve") {
+        return runServer(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--queries") {
+        return runQueries(argc, argv);
+    }
 
-    // Parse and display configuration.
+    // Parse configuration first: structured output modes move status messages to stderr.
     Config config = ConfigParser::parseConfig("config.toml");
+    std::string lowerPrintMode = config.printMode;
+    std::transform(lowerPrintMode.begin(), lowerPrintMode.end(), lowerPrintMode.begin(), ::tolower);
+    Console::setStatusToStderr(lowerPrintMode == "ndjson" || lowerPrintMode == "csv");
+
+    printTimestamp("PROGRAM START");
 
-    std::cout << ColorUtils::info("Configuration:") << std::endl;
-    std::cout << "  Threads: " << ColorUtils::bold(std::to_string(config.threads)) << std::endl;
-    std::cout << "  Upper Limit: " << ColorUtils::bold(std::to_string(config.upperLimit)) << std::endl;
-    std::cout << "  Print Mode: " << ColorUtils::highlight(config.printMode) << std::endl;
-    std::cout << "  Division Mode: " << ColorUtils::highlight(config.divisionMode) << std::endl;
-    std::cout << std::endl;
+    std::ostream &status = Console::status();
+    status << ColorUtils::bold("=== ") << ColorUtils::highlight("Prime Number Finder")
+           << ColorUtils::bold(" ===") << std::endl;
+
+    // Display configuration.
+    status << ColorUtils::info("Configuration:") << std::endl;
+    status << "  Threads: " << ColorUtils::bold(std::to_string(config.threads));
+    if (config.autoThreads) {
+        status << " " << ColorUtils::info("(auto: " + config.threadsReason + ")");
+    }
+    status << std::endl;
+    status << "  Upper Limit: " << ColorUtils::bold(std::to_string(config.upperLimit)) << std::endl;
+    status << "  Print Mode: " << ColorUtils::highlight(config.printMode) << std::endl;
+    status << "  Division Mode: " << ColorUtils::highlight(config.divisionMode) << std::endl;
+    bool binaryOutput = lowerPrintMode == "binary";
+    if (binaryOutput) {
+        status << "  Binary Encoding: " << ColorUtils::highlight(config.binaryEncoding) << std::endl;
+    }
+    if (!config.outputFile.empty()) {
+        status << "  Output File: " << ColorUtils::highlight(config.outputFile) << std::endl;
+    }
+    if (config.outputIo != "write") {
+        status << "  Output I/O: " << ColorUtils::highlight(config.outputIo) << std::endl;
+    }
+    if (config.outputBackpressure != "off") {
+        status << "  Async Output: " << ColorUtils::highlight(config.outputBackpressure) << std::endl;
+    }
+    if (config.progressIntervalMs > 0) {
+        status << "  Progress: every " << ColorUtils::bold(std::to_string(config.progressIntervalMs))
+               << "ms to " << ColorUtils::highlight(config.progressOutput) << std::endl;
+    }
+    status << std::endl;
 
     // Execute prime finding with error handling.
     try {
-        // Create strategies using factory.
-        auto printStrategy =
-            PrimeFinderFactory::createPrintStrategy(PrimeFinderFactory::parsePrintMode(config.printMode));
+        // Stream results into the print strategy; sample progress from a background reporter when enabled.
+        SearchOptions options; // The print strategy is the only consumer of the primes.
+        std::unique_ptr<ProgressReporter> reporter;
+        if (config.progressIntervalMs > 0) {
+            options.progress = std::make_shared<ProgressTracker>(config.threads);
+            auto interval = std::chrono::milliseconds(config.progressIntervalMs);
+            reporter = std::make_unique<ProgressReporter>(options.progress, interval, config.progressOutput);
+        }
 
-        auto divisionStrategy = PrimeFinderFactory::createDivisionStrategy(
-            PrimeFinderFactory::parseDivisionMode(config.divisionMode));
+        // Execute prime finding; the factory picks the strategy combination once, here at the top.
+        status << ColorUtils::info("Starting prime finding...") << std::endl;
+        auto writer = PrimeFinderFactory::createOutputWriter(config);
+        // These print strategies write their own files.
+        bool ownsFile = lowerPrintMode == "file" || lowerPrintMode == "live" || lowerPrintMode == "sharded";
+        bool fileOutput = binaryOutput || (!config.outputFile.empty() && !ownsFile);
+        // Text going to output_file must not carry the terminal's color codes.
+        bool colors = ColorUtils::isColorEnabled();
+        ColorUtils::setColorEnabled(colors && !fileOutput);
+        // Per-thread status lines would tear the live status line, so they are dropped while it is drawn.
+        Console::setStatusMuted(lowerPrintMode == "live");
+        auto result = PrimeFinderFactory::findPrimesAsync(config, options, writer).take();
+        Console::setStatusMuted(false);
+        ColorUtils::setColorEnabled(colors);
+        if (reporter) {
+            reporter->stop();
+        }
+        auto async = std::dynamic_pointer_cast<AsyncOutputWriter>(writer);
+        if (async && async->droppedLines() > 0) {
+            std::cerr << ColorUtils::warning("[OUTPUT] Dropped " + std::to_string(async->droppedLines()) +
+                                             " lines while output was backed up")
+                      << std::endl;
+        }
 
-        // Execute prime finding.
-        std::cout << ColorUtils::info("Starting prime finding...") << std::endl;
-        auto primes = divisionStrategy->findPrimes(config.upperLimit, config.threads, printStrategy);
+        auto fileWriter = std::dynamic_pointer_cast<FdOutputWriter>(writer);
+        auto uringWriter = std::dynamic_pointer_cast<UringOutputWriter>(writer);
+        if ((fileWriter || uringWriter) && fileOutput) {
+            uint64_t bytes = fileWriter ? fileWriter->bytesWritten() : uringWriter->bytesWritten();
+            status << ColorUtils::info("[OUTPUT]") << " Wrote " << bytes << " bytes" << std::endl;
+        }
 
-        std::cout << std::endl << ColorUtils::success("Execution completed successfully!") << std::endl;
+        status << std::endl << ColorUtils::success("Execution completed successfully!") << std::endl;
 
     } catch (const std::exception &e) {
         std::cerr << ColorUtils::error("Error: " + std::string(e.what())) << std::endl;
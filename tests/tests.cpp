@@ -1,13 +1,62 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
+#include "../include/AsyncOutputWriter.h"
+#include "../include/BatchPlanner.h"
+#include "../include/BinaryPrintStrategy.h"
 #include "../include/ConfigParser.h"
+#include "../include/CountPrintStrategy.h"
+#include "../include/FilePrintStrategy.h"
 #include "../include/PrimeFinderFactory.h"
 #include "../include/PrimeUtils.h"
 #include "../include/RangeDivisionStrategy.h"
+#include "../include/ResultSinks.h"
+#include "../include/ShardedPrintStrategy.h"
+#include "../include/StructuredPrintStrategy.h"
 #include "../include/QueueDivisionStrategy.h"
+#include "../include/ProcessDivisionStrategy.h"
+#include "../include/ClusterDivisionStrategy.h"
+#include "../include/ClusterProtocol.h"
+#include "../include/ClusterWorker.h"
+#include "../include/ColorUtils.h"
+#include "../include/Console.h"
+#include "../include/EventClock.h"
+#include "../include/GapCodec.h"
+#include "../include/PrimeCache.h"
+#include "../include/PrimeFinder.h"
+#include "../include/PrimeServer.h"
+#include "../include/QueryProtocol.h"
 #include "../include/ImmediatePrintStrategy.h"
+#include "../include/IntervalQueryEngine.h"
+#include "../include/LivePrintStrategy.h"
+#include "../include/OrderedPrintStrategy.h"
+#include "../include/OutputWriter.h"
 #include "../include/BatchPrintStrategy.h"
+#include "../include/ProgressReporter.h"
+#include "../include/ProgressTracker.h"
+#include "../include/ThreadPool.h"
+#include "../include/ThreadUtils.h"
+#include "../include/UringOutputWriter.h"
 #include <algorithm>
+#include <numeric>
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <stop_token>
+
+// Search options that also return the primes in PrimeSearchResult::primes.
+SearchOptions collectingOptions() {
+    SearchOptions options;
+    options.collectPrimes = true;
+    return options;
+}
 
 TEST_CASE("Config Parser - Default Values") {
     Config defaultConfig = ConfigParser::parseConfig("nonexistent.toml");
@@ -18,6 +67,50 @@ TEST_CASE("Config Parser - Default Values") {
     CHECK(defaultConfig.divisionMode == "range");
 }
 
+TEST_CASE("Config Parser - Automatic Thread Count") {
+    {
+        std::ofstream file("test_auto_threads.toml");
+        file << "threads = \"auto\"\n";
+    }
+    Config config = ConfigParser::parseConfig("test_auto_threads.toml");
+    std::remove("test_auto_threads.toml");
+
+    CHECK(config.autoThreads);
+    CHECK(config.threads >= 1);
+    CHECK_FALSE(config.threadsReason.empty());
+}
+
+TEST_CASE("Thread Utils - Cgroup and Topology Parsing") {
+    SUBCASE("Cgroup v2 cpu.max") {
+        CHECK(ThreadUtils::parseCgroupV2CpuMax("200000 100000") == 2.0);
+        CHECK(ThreadUtils::parseCgroupV2CpuMax("50000 100000") == 0.5);
+        CHECK_FALSE(ThreadUtils::parseCgroupV2CpuMax("max 100000").has_value());
+        CHECK_FALSE(ThreadUtils::parseCgroupV2CpuMax("").has_value());
+    }
+
+    SUBCASE("Cgroup v1 CFS quota") {
+        CHECK(ThreadUtils::parseCgroupV1Quota("300000", "100000") == 3.0);
+        CHECK_FALSE(ThreadUtils::parseCgroupV1Quota("-1", "100000").has_value());
+        CHECK_FALSE(ThreadUtils::parseCgroupV1Quota("garbage", "100000").has_value());
+    }
+
+    SUBCASE("CPU lists") {
+        CHECK(ThreadUtils::parseCpuListCount("0") == 1);
+        CHECK(ThreadUtils::parseCpuListCount("0,4") == 2);
+        CHECK(ThreadUtils::parseCpuListCount("0-3,8,10-11") == 7);
+        CHECK(ThreadUtils::parseCpuListCount("") == 0);
+        CHECK(ThreadUtils::parseCpuListCount("3-1") == 0);
+    }
+
+    SUBCASE("Cores behind the affinity mask") {
+        // taskset -c 0,2,4,6 on a 2-way SMT host: one sibling of each of four cores.
+        CHECK(ThreadUtils::countDistinctCores({"0-1", "2-3", "4-5", "6-7"}) == 4);
+        CHECK(ThreadUtils::countDistinctCores({"0-1", "0-1", "2-3"}) == 2);
+        CHECK(ThreadUtils::countDistinctCores({"0,4", "", ""}) == 3);
+        CHECK(ThreadUtils::countDistinctCores({}) == 0);
+    }
+}
+
 TEST_CASE("Factory - Print Strategy Creation") {
     SUBCASE("Immediate Print Strategy") {
         auto strategy = PrimeFinderFactory::createPrintStrategy(PrintMode::IMMEDIATE);
@@ -57,6 +150,8 @@ TEST_CASE("Factory - Mode Parsing") {
         CHECK(PrimeFinderFactory::parseDivisionMode("RANGE") == DivisionMode::RANGE);
         CHECK(PrimeFinderFactory::parseDivisionMode("queue") == DivisionMode::QUEUE);
         CHECK(PrimeFinderFactory::parseDivisionMode("QUEUE") == DivisionMode::QUEUE);
+        CHECK(PrimeFinderFactory::parseDivisionMode("process") == DivisionMode::PROCESS);
+        CHECK(PrimeFinderFactory::parseDivisionMode("cluster") == DivisionMode::CLUSTER);
         
         CHECK_THROWS(PrimeFinderFactory::parseDivisionMode("invalid"));
     }
@@ -437,4 +532,1543 @@ TEST_CASE("Stress Tests - Both Strategies") {
         CHECK(std::find(foundPrimes.begin(), foundPrimes.end(), 9967) != foundPrimes.end());
         CHECK(std::find(foundPrimes.begin(), foundPrimes.end(), 9949) != foundPrimes.end());
     }
-}
\ No newline at end of file
+}
+
+// Print strategy that requests a stop as soon as the first primes are reported.
+class StopOnFirstPrimeStrategy : public BatchPrintStrategy {
+public:
+    explicit StopOnFirstPrimeStrategy(std::stop_source source) : stopSource(std::move(source)) {}
+
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override {
+        if (!primes.empty()) {
+            stopSource.request_stop();
+        }
+        BatchPrintStrategy::printPrimes(primes, info);
+    }
+
+private:
+    std::stop_source stopSource;
+};
+
+TEST_CASE("Segment Planner - Splitting") {
+    auto segments = SegmentPlanner::split(1, 10, 4, 3);
+    REQUIRE(segments.size() == 3);
+    CHECK(segments[0].index == 3);
+    CHECK(segments[0].start == 1);
+    CHECK(segments[0].end == 4);
+    CHECK(segments[2].index == 5);
+    CHECK(segments[2].start == 9);
+    CHECK(segments[2].end == 10);
+
+    CHECK(SegmentPlanner::split(5, 4, 4).empty());
+}
+
+TEST_CASE("Cancellation and Deadlines - Both Strategies") {
+    RangeDivisionStrategy rangeStrategy;
+    QueueDivisionStrategy queueStrategy;
+    ITaskDivisionStrategy *strategies[] = {&rangeStrategy, &queueStrategy};
+
+    SUBCASE("Uncancelled Run Is Complete") {
+        for (ITaskDivisionStrategy *strategy : strategies) {
+            SearchOptions options;
+            options.collectPrimes = true;
+            options.segmentSize = 64;
+            auto result = strategy->findPrimes(1000, 4, std::make_shared<BatchPrintStrategy>(), options);
+            std::sort(result.primes.begin(), result.primes.end());
+
+            CHECK(result.complete);
+            CHECK(result.primes == PrimeUtils::getKnownPrimes(1000));
+        }
+    }
+
+    SUBCASE("Stop Requested Before Start") {
+        for (ITaskDivisionStrategy *strategy : strategies) {
+            std::stop_source source;
+            source.request_stop();
+            SearchOptions options;
+            options.collectPrimes = true;
+            options.stopToken = source.get_token();
+            auto result = strategy->findPrimes(1000, 4, std::make_shared<BatchPrintStrategy>(), options);
+
+            CHECK_FALSE(result.complete);
+            CHECK(result.primes.empty());
+        }
+    }
+
+    SUBCASE("Expired Deadline") {
+        for (ITaskDivisionStrategy *strategy : strategies) {
+            SearchOptions options;
+            options.collectPrimes = true;
+            options.deadline = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+            auto result = strategy->findPrimes(1000, 2, std::make_shared<BatchPrintStrategy>(), options);
+
+            CHECK_FALSE(result.complete);
+            CHECK(result.primes.empty());
+        }
+    }
+
+    SUBCASE("Stop Takes Effect Within One Segment") {
+        for (ITaskDivisionStrategy *strategy : strategies) {
+            std::stop_source source;
+            SearchOptions options;
+            options.collectPrimes = true;
+            options.stopToken = source.get_token();
+            options.segmentSize = 100;
+            auto result = strategy->findPrimes(1000, 1, std::make_shared<StopOnFirstPrimeStrategy>(source), options);
+            std::sort(result.primes.begin(), result.primes.end());
+
+            // Only the first segment finishes, and it finishes completely.
+            auto expected = PrimeUtils::getKnownPrimes(result.primes.empty() ? 1 : result.primes.back());
+            CHECK_FALSE(result.complete);
+            CHECK(result.primes == expected);
+            CHECK(result.primes.back() < 102);
+        }
+    }
+}
+
+TEST_CASE("Async Search - Futures and Shared Pool") {
+    SUBCASE("findPrimesAsync Returns Without Blocking") {
+        QueueDivisionStrategy strategy;
+        auto task =
+            strategy.findPrimesAsync(2000, 4, std::make_shared<BatchPrintStrategy>(), collectingOptions());
+        CHECK(task.valid());
+
+        auto primes = task.get().primes;
+        std::sort(primes.begin(), primes.end());
+        CHECK(task.get().complete);
+        CHECK(primes == PrimeUtils::getKnownPrimes(2000));
+    }
+
+    SUBCASE("Continuation Chaining") {
+        RangeDivisionStrategy strategy;
+        SearchOptions options = collectingOptions();
+        auto count = strategy.findPrimesAsync(1000, 3, std::make_shared<BatchPrintStrategy>(), options)
+                         .then([](const PrimeSearchResult &result) { return result.primes.size(); })
+                         .then([](size_t primeCount) { return primeCount * 2; });
+
+        CHECK(count.get() == 2 * 168);
+    }
+
+    SUBCASE("Continuation Failure Propagates") {
+        RangeDivisionStrategy strategy;
+        auto failed = strategy.findPrimesAsync(100, 2, std::make_shared<BatchPrintStrategy>(), SearchOptions{})
+                          .then([](const PrimeSearchResult &) -> int { throw std::runtime_error("boom"); })
+                          .then([](int value) { return value + 1; });
+
+        CHECK_THROWS_AS(failed.get(), std::runtime_error);
+    }
+
+    SUBCASE("Concurrent Jobs Share Workers") {
+        ThreadPool::shared().ensureWorkers(4);
+        size_t workersBefore = ThreadPool::shared().workerCount();
+
+        RangeDivisionStrategy rangeStrategy;
+        QueueDivisionStrategy queueStrategy;
+        SearchOptions options = collectingOptions();
+        auto first = rangeStrategy.findPrimesAsync(3000, 4, std::make_shared<BatchPrintStrategy>(), options);
+        auto second = queueStrategy.findPrimesAsync(3000, 4, std::make_shared<BatchPrintStrategy>(), options);
+
+        CHECK(first.get().primes.size() == 430);
+        CHECK(second.get().primes.size() == 430);
+        CHECK(ThreadPool::shared().workerCount() == workersBefore);
+    }
+}
+
+TEST_CASE("Progress Reporting - Tracker and Reporter") {
+    SUBCASE("Counters Cover The Whole Search") {
+        RangeDivisionStrategy rangeStrategy;
+        QueueDivisionStrategy queueStrategy;
+
+        SearchOptions rangeOptions;
+        rangeOptions.segmentSize = 100;
+        rangeOptions.progress = std::make_shared<ProgressTracker>(4);
+        rangeStrategy.findPrimes(1000, 4, std::make_shared<BatchPrintStrategy>(), rangeOptions);
+
+        auto range = rangeOptions.progress->snapshot();
+        CHECK(range.candidates == 1000);
+        CHECK(range.totalCandidates == 1000);
+        CHECK(range.segments == range.totalSegments);
+        CHECK(range.primes == 168);
+
+        SearchOptions queueOptions;
+        queueOptions.segmentSize = 100;
+        queueOptions.progress = std::make_shared<ProgressTracker>(3);
+        queueStrategy.findPrimes(1000, 3, std::make_shared<BatchPrintStrategy>(), queueOptions);
+
+        auto queue = queueOptions.progress->snapshot();
+        CHECK(queue.candidates == 999); // Queue division starts at 2.
+        CHECK(queue.segments == 10);
+        CHECK(queue.totalSegments == 10);
+        CHECK(queue.primes == 168);
+    }
+
+    SUBCASE("Report Formatting") {
+        ProgressTracker::Snapshot previous{100, 1, 25, 1000, 10};
+        ProgressTracker::Snapshot current{500, 5, 95, 1000, 10};
+        std::string line = ProgressReporter::formatReport(current, previous, std::chrono::seconds(2),
+                                                          std::chrono::seconds(5));
+
+        CHECK(line.find("50.0%") != std::string::npos);
+        CHECK(line.find("5/10 segments") != std::string::npos);
+        CHECK(line.find("200.0 candidates/s") != std::string::npos);
+        CHECK(line.find("ETA 5.0s") != std::string::npos);
+    }
+
+    SUBCASE("Reporter Writes To File") {
+        auto tracker = std::make_shared<ProgressTracker>(1);
+        tracker->setTotals(10, 1);
+        {
+            ProgressReporter reporter(tracker, std::chrono::milliseconds(5), "test_progress.log");
+            tracker->recordSegment(0, 10, 4);
+            reporter.stop();
+        }
+
+        std::ifstream file("test_progress.log");
+        std::stringstream contents;
+        contents << file.rdbuf();
+        std::remove("test_progress.log");
+
+        CHECK(contents.str().find("[PROGRESS] 100.0%") != std::string::npos);
+        CHECK(contents.str().find("4 primes") != std::string::npos);
+    }
+}
+
+TEST_CASE("Process Division - Worker Processes") {
+    SUBCASE("Matches Reference Primes") {
+        ProcessDivisionStrategy strategy;
+        SearchOptions options;
+        options.collectPrimes = true;
+        options.segmentSize = 500;
+        auto result = strategy.findPrimes(10000, 3, std::make_shared<BatchPrintStrategy>(), options);
+        std::sort(result.primes.begin(), result.primes.end());
+
+        CHECK(result.complete);
+        CHECK(result.primes == PrimeUtils::getKnownPrimes(10000));
+    }
+
+    SUBCASE("Crashed Worker Segments Are Reassigned") {
+        ProcessDivisionStrategy strategy;
+        strategy.setSegmentHook([](const Segment &segment, int attempt) {
+            if (segment.index == 2 && attempt == 1) {
+                _exit(3);
+            }
+        });
+
+        SearchOptions options;
+        options.collectPrimes = true;
+        options.segmentSize = 256;
+        auto result = strategy.findPrimes(5000, 2, std::make_shared<BatchPrintStrategy>(), options);
+        std::sort(result.primes.begin(), result.primes.end());
+
+        CHECK(result.complete);
+        CHECK(result.primes == PrimeUtils::getKnownPrimes(5000));
+    }
+
+    SUBCASE("Persistently Failing Segment Is Abandoned") {
+        ProcessDivisionStrategy strategy;
+        strategy.setSegmentHook([](const Segment &segment, int) {
+            if (segment.index == 1) {
+                _exit(3);
+            }
+        });
+
+        SearchOptions options;
+        options.collectPrimes = true;
+        options.segmentSize = 64;
+        auto result = strategy.findPrimes(256, 2, std::make_shared<BatchPrintStrategy>(), options);
+        std::sort(result.primes.begin(), result.primes.end());
+
+        // Segment 1 covers 64-127; everything else is still found.
+        std::vector<int> expected;
+        for (int prime : PrimeUtils::getKnownPrimes(256)) {
+            if (prime < 64 || prime > 127) {
+                expected.push_back(prime);
+            }
+        }
+        CHECK_FALSE(result.complete);
+        CHECK(result.primes == expected);
+    }
+}
+
+TEST_CASE("Gap Codec - Round Trip") {
+    std::vector<int> primes = {101, 103, 107, 109, 113, 127, 131};
+    std::string encoded;
+    GapCodec::encodeGaps(encoded, primes, 100);
+    CHECK(encoded.size() == primes.size()); // Every gap fits in one byte.
+
+    std::vector<int> decoded;
+    size_t pos = 0;
+    CHECK(GapCodec::decodeGaps(encoded, pos, primes.size(), 100, decoded));
+    CHECK(decoded == primes);
+    CHECK(pos == encoded.size());
+
+    std::string large;
+    GapCodec::appendVarint(large, 300);
+    uint64_t value = 0;
+    pos = 0;
+    CHECK(GapCodec::readVarint(large, pos, value));
+    CHECK(value == 300);
+
+    pos = 0;
+    CHECK_FALSE(GapCodec::readVarint(large.substr(0, 1), pos, value));
+}
+
+// Connect to a coordinator on localhost, take one lease and never answer it.
+int connectStalledWorker(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+    ClusterProtocol::sendAll(fd, ClusterProtocol::frame(ClusterMessage::HELLO));
+    return fd;
+}
+
+TEST_CASE("Cluster Division - Localhost Workers") {
+    SUBCASE("Several Workers Produce Reference Primes") {
+        ClusterDivisionStrategy strategy(0, std::chrono::milliseconds(2000));
+        SearchOptions options;
+        options.collectPrimes = true;
+        options.segmentSize = 500;
+        auto task = strategy.findPrimesAsync(20000, 1, std::make_shared<BatchPrintStrategy>(), options);
+
+        std::vector<std::thread> workers;
+        std::atomic<long> processed{0};
+        for (int i = 0; i < 3; ++i) {
+            workers.emplace_back([&]() { processed += ClusterWorker::run("127.0.0.1", strategy.port(), 2); });
+        }
+
+        auto result = task.get();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        std::sort(result.primes.begin(), result.primes.end());
+
+        CHECK(result.complete);
+        CHECK(result.primes == PrimeUtils::getKnownPrimes(20000));
+        CHECK(processed.load() >= 40);
+    }
+
+    SUBCASE("Counting Sink Receives Counts Only") {
+        ClusterDivisionStrategy strategy(0, std::chrono::milliseconds(2000));
+        SearchOptions options;
+        options.segmentSize = 5000;
+        auto sink = std::make_shared<CountSink>();
+        auto task = strategy.findPrimesAsync(100000, 1, sink, options);
+
+        // A lease for a counting sink does not ask for the primes.
+        int fd = connectStalledWorker(strategy.port());
+        ClusterMessage type;
+        std::string payload;
+        REQUIRE(ClusterProtocol::receiveFrame(fd, type, payload));
+        LeaseMessage lease;
+        REQUIRE(ClusterProtocol::decodeLease(payload, lease));
+        CHECK_FALSE(lease.wantPrimes);
+        close(fd);
+
+        std::thread worker([&]() { ClusterWorker::run("127.0.0.1", strategy.port(), 2); });
+        auto result = task.get();
+        worker.join();
+
+        CHECK(result.complete);
+        CHECK(result.primeCount == 9592);
+        CHECK(sink->count() == 9592);
+        CHECK(result.primes.empty());
+    }
+
+    SUBCASE("Expired Lease Is Re-dispatched") {
+        ClusterDivisionStrategy strategy(0, std::chrono::milliseconds(100));
+        SearchOptions options;
+        options.collectPrimes = true;
+        options.segmentSize = 1000;
+        auto task = strategy.findPrimesAsync(5000, 1, std::make_shared<BatchPrintStrategy>(), options);
+
+        // The stalled worker connects first and holds a lease it never answers.
+        int stalled = connectStalledWorker(strategy.port());
+        ClusterMessage type;
+        std::string payload;
+        REQUIRE(ClusterProtocol::receiveFrame(stalled, type, payload));
+        CHECK(type == ClusterMessage::LEASE);
+
+        std::thread worker([&]() { ClusterWorker::run("127.0.0.1", strategy.port(), 1); });
+        auto result = task.get();
+        worker.join();
+        close(stalled);
+        std::sort(result.primes.begin(), result.primes.end());
+
+        CHECK(result.complete);
+        CHECK(result.primes == PrimeUtils::getKnownPrimes(5000));
+    }
+
+    SUBCASE("Stop Without Workers Returns Incomplete") {
+        ClusterDivisionStrategy strategy(0);
+        std::stop_source source;
+        SearchOptions options;
+        options.collectPrimes = true;
+        options.stopToken = source.get_token();
+        auto task = strategy.findPrimesAsync(1000, 1, std::make_shared<BatchPrintStrategy>(), options);
+        source.request_stop();
+
+        CHECK_FALSE(task.get().complete);
+        CHECK(task.get().primes.empty());
+    }
+}
+
+TEST_CASE("Prime Utils - Segmented Sieve") {
+    // Sieve [start, end) into a bitmap and read its primes back.
+    auto sieve = [](int64_t start, int64_t end) {
+        std::vector<uint64_t> bits(static_cast<size_t>((end - start + 63) / 64));
+        std::vector<int> basePrimes = PrimeUtils::basePrimesFor(static_cast<int>(end - 1));
+        PrimeUtils::sieveSegment(start, end, basePrimes, bits.data());
+        std::vector<int> primes;
+        PrimeUtils::appendSegmentPrimes(start, end - start, bits.data(), primes);
+        return primes;
+    };
+    CHECK(sieve(2, 10001) == PrimeUtils::getKnownPrimes(10000));
+    CHECK(sieve(1000000, 1000101) == PrimeUtils::findPrimesInRange(1000000, 1000100));
+    CHECK(sieve(24, 29).empty());
+}
+
+TEST_CASE("Prime Cache - Queries") {
+    PrimeCache cache;
+    cache.ensure(1000);
+    CHECK(cache.limit() >= 1000);
+
+    CHECK(cache.isPrime(2));
+    CHECK(cache.isPrime(997));
+    CHECK_FALSE(cache.isPrime(1));
+    CHECK_FALSE(cache.isPrime(1001));
+
+    CHECK(cache.count(0, 100) == 25);
+    CHECK(cache.count(0, 1000000) == 78498);
+    CHECK(cache.count(100, 200) == PrimeUtils::findPrimesInRange(100, 200).size());
+
+    std::vector<uint32_t> primes;
+    REQUIRE(cache.collect(60, 130, 100, primes));
+    CHECK(primes == std::vector<uint32_t>{61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127});
+    CHECK_FALSE(cache.collect(0, 1000, 10, primes));
+
+    CHECK(cache.nthPrime(1) == 2);
+    CHECK(cache.nthPrime(25) == 97);
+    CHECK(cache.nthPrime(10000) == 104729);
+    CHECK_FALSE(cache.nthPrime(0).has_value());
+
+    CHECK(cache.nextPrime(-5) == 2);
+    CHECK(cache.nextPrime(13) == 17);
+    CHECK(cache.nextPrime(cache.limit()).has_value());
+
+    // A ceiling bounds how far queries can make the cache grow.
+    PrimeCache bounded(ThreadPool::shared(), 10000);
+    CHECK(bounded.nthPrime(1229) == 9973);
+    CHECK_FALSE(bounded.nthPrime(1230).has_value());
+    CHECK_FALSE(bounded.nthPrime(100000000).has_value());
+    CHECK_FALSE(bounded.nextPrime(9973).has_value());
+    CHECK(bounded.limit() < 10064);
+    PrimeServer boundedServer(bounded);
+    CHECK(boundedServer.answer({QueryOp::IS_PRIME, 1, 10007, 0}).status == QueryStatus::OUT_OF_RANGE);
+    CHECK(boundedServer.answer({QueryOp::NEXT_PRIME, 2, 2000000000, 0}).status == QueryStatus::OUT_OF_RANGE);
+    CHECK(boundedServer.answer({QueryOp::COUNT, 3, 0, 10000}).values == std::vector<uint32_t>{1229});
+}
+
+TEST_CASE("Prime Server - Pipelined Requests Over Unix Socket") {
+    PrimeCache cache;
+    cache.ensure(10000);
+    PrimeServer server(cache);
+    std::string path = "/tmp/prime_finder_test_" + std::to_string(getpid()) + ".sock";
+    REQUIRE(server.listen(path));
+    std::jthread serverThread([&server](std::stop_token stop) { server.run(stop); });
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), address.sun_path);
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+
+    // Send every request in one write; responses come back in order.
+    std::string requests;
+    QueryProtocol::encodeRequest(requests, {QueryOp::IS_PRIME, 1, 7919, 0});
+    QueryProtocol::encodeRequest(requests, {QueryOp::COUNT, 2, 0, 10000});
+    QueryProtocol::encodeRequest(requests, {QueryOp::RANGE, 3, 10, 20});
+    QueryProtocol::encodeRequest(requests, {QueryOp::NTH_PRIME, 4, 100, 0});
+    QueryProtocol::encodeRequest(requests, {QueryOp::NEXT_PRIME, 5, 10000, 0});
+    QueryProtocol::encodeRequest(requests, {QueryOp::COUNT, 6, 50, 10});
+    QueryProtocol::encodeRequest(requests, {static_cast<QueryOp>(99), 7, 0, 0});
+    REQUIRE(write(fd, requests.data(), requests.size()) == static_cast<ssize_t>(requests.size()));
+
+    std::vector<QueryResponse> responses;
+    std::string buffer;
+    char chunk[4096];
+    while (responses.size() < 7) {
+        QueryResponse response;
+        if (QueryProtocol::takeResponse(buffer, response)) {
+            responses.push_back(response);
+            continue;
+        }
+        ssize_t received = read(fd, chunk, sizeof(chunk));
+        REQUIRE(received > 0);
+        buffer.append(chunk, static_cast<size_t>(received));
+    }
+    close(fd);
+
+    for (uint32_t i = 0; i < responses.size(); ++i) {
+        CHECK(responses[i].id == i + 1);
+    }
+    CHECK(responses[0].values == std::vector<uint32_t>{1});
+    CHECK(responses[1].values == std::vector<uint32_t>{1229});
+    CHECK(responses[2].values == std::vector<uint32_t>{11, 13, 17, 19});
+    CHECK(responses[3].values == std::vector<uint32_t>{541});
+    CHECK(responses[4].values == std::vector<uint32_t>{10007});
+    CHECK(responses[5].status == QueryStatus::BAD_REQUEST);
+    CHECK(responses[6].status == QueryStatus::BAD_REQUEST);
+
+    // A client that shuts down its side after sending still gets every answer before the close.
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+    requests.clear();
+    QueryProtocol::encodeRequest(requests, {QueryOp::RANGE, 8, 0, 10000});
+    REQUIRE(write(fd, requests.data(), requests.size()) == static_cast<ssize_t>(requests.size()));
+    shutdown(fd, SHUT_WR);
+    buffer.clear();
+    for (ssize_t received; (received = read(fd, chunk, sizeof(chunk))) > 0;) {
+        buffer.append(chunk, static_cast<size_t>(received));
+    }
+    close(fd);
+    QueryResponse halfClosed;
+    REQUIRE(QueryProtocol::takeResponse(buffer, halfClosed));
+    CHECK(halfClosed.id == 8);
+    CHECK(halfClosed.values.size() == 1229);
+    CHECK(buffer.empty());
+}
+
+TEST_CASE("Batch Planner - Overlapping Queries") {
+    std::istringstream input("# start end [output]\n"
+                             "100 200\n"
+                             "\n"
+                             "150 300\n"
+                             "301 310\n"
+                             "0 10\n"
+                             "1000 1100 batch_test_output.txt\n");
+    auto queries = BatchPlanner::parse(input);
+    REQUIRE(queries.size() == 5);
+    CHECK(queries[4].output == "batch_test_output.txt");
+
+    SUBCASE("Ranges Are Merged Into Minimal Segments") {
+        BatchPlan plan = BatchPlanner::plan(queries, 64);
+        CHECK(plan.ranges == std::vector<std::pair<int, int>>{{2, 10}, {100, 310}, {1000, 1100}});
+        CHECK(plan.sieved == 9 + 211 + 101);
+        CHECK(plan.requested == 101 + 151 + 10 + 11 + 101);
+        for (size_t i = 0; i < plan.segments.size(); ++i) {
+            CHECK(plan.segments[i].index == static_cast<int>(i));
+        }
+    }
+
+    SUBCASE("Each Query Gets Its Own Primes") {
+        BatchPlan plan = BatchPlanner::plan(queries, 64);
+        std::vector<int> primes = BatchPlanner::execute(plan, 2);
+        for (const BatchQuery &query : queries) {
+            auto result = BatchPlanner::primesFor(primes, query);
+            CHECK(std::vector<int>(result.begin(), result.end()) ==
+                  PrimeUtils::findPrimesInRange(query.start, query.end));
+        }
+
+        std::ostringstream console;
+        BatchPlanner::writeResults(queries, primes, console);
+        CHECK(console.str().find("# [0, 10] 4 primes\n2 3 5 7\n") != std::string::npos);
+
+        std::ifstream file("batch_test_output.txt");
+        int first = 0;
+        file >> first;
+        CHECK(first == 1009);
+        std::remove("batch_test_output.txt");
+    }
+
+    SUBCASE("Malformed Line Is Rejected") {
+        std::istringstream bad("1 10\nabc\n");
+        CHECK_THROWS_AS(BatchPlanner::parse(bad), std::invalid_argument);
+        // Trailing junk in a bound is not silently dropped.
+        std::istringstream junkEnd("10 20x\n");
+        CHECK_THROWS_AS(BatchPlanner::parse(junkEnd), std::invalid_argument);
+        std::istringstream junkStart("10abc 20\n");
+        CHECK_THROWS_AS(BatchPlanner::parse(junkStart), std::invalid_argument);
+        std::istringstream missingEnd("10\n");
+        CHECK_THROWS_AS(BatchPlanner::parse(missingEnd), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Interval Query Engine - Single Sweep") {
+    SUBCASE("Answers Match Per-Query Search") {
+        std::vector<IntervalQuery> queries = {
+            {500, 700, false}, {0, 100, true}, {90, 90000, false}, {129, 129, true},
+            {100, 50, false},  {-10, 1, true}, {4000, 4200, true}, {65530, 65600, true},
+        };
+        auto answers = IntervalQueryEngine::answer(queries, 3, 128);
+        REQUIRE(answers.size() == queries.size());
+
+        for (size_t q = 0; q < queries.size(); ++q) {
+            auto expected = PrimeUtils::findPrimesInRange(queries[q].start, queries[q].end);
+            CHECK(answers[q].count == expected.size());
+            if (queries[q].listPrimes) {
+                CHECK(answers[q].primes == expected);
+            } else {
+                CHECK(answers[q].primes.empty());
+            }
+        }
+    }
+
+    SUBCASE("Parse And Write Keep Input Order") {
+        std::istringstream input("# kind start end\nlist 10 20\ncount 0 100\n");
+        auto queries = IntervalQueryEngine::parse(input);
+        std::ostringstream output;
+        IntervalQueryEngine::write(queries, IntervalQueryEngine::answer(queries, 2), output);
+        CHECK(output.str() == "4 11 13 17 19\n25\n");
+
+        std::istringstream bad("sum 1 2\n");
+        CHECK_THROWS_AS(IntervalQueryEngine::parse(bad), std::invalid_argument);
+    }
+}
+
+// Sink that counts how it was called, to tell direct from virtual delivery apart.
+class CountingPrintStrategy : public BatchPrintStrategy {
+public:
+    void printPrimes(std::span<const int> primes, const SegmentInfo &info) override {
+        calls += static_cast<int>(primes.size());
+        BatchPrintStrategy::printPrimes(primes, info);
+    }
+
+    std::atomic<int> calls{0};
+};
+
+TEST_CASE("Prime Finder - Compile-Time Policies") {
+    SUBCASE("Static Combinations Match The Virtual Path") {
+        auto expected = PrimeUtils::getKnownPrimes(5000);
+        SearchOptions options = collectingOptions();
+        auto range = PrimeFinder<RangeDivisionStrategy, BatchPrintStrategy>().findPrimes(5000, 3, options);
+        auto queue = PrimeFinder<QueueDivisionStrategy, BatchPrintStrategy>().findPrimes(5000, 3, options);
+        std::sort(range.primes.begin(), range.primes.end());
+        std::sort(queue.primes.begin(), queue.primes.end());
+
+        CHECK(range.complete);
+        CHECK(range.primes == expected);
+        CHECK(queue.primes == expected);
+    }
+
+    SUBCASE("IPrintStrategy Instantiation Still Dispatches Virtually") {
+        auto sink = std::make_shared<CountingPrintStrategy>();
+        std::shared_ptr<IPrintStrategy> plugin = sink;
+        RangeDivisionStrategy strategy;
+        auto primes = strategy.findPrimes(1000, 2, plugin);
+
+        CHECK(sink->calls == 168);
+        CHECK(primes.size() == 168);
+    }
+
+    SUBCASE("Factory Dispatches From Config") {
+        Config config;
+        config.threads = 2;
+        config.upperLimit = 2000;
+        config.printMode = "batch";
+        config.divisionMode = "queue";
+        auto result = PrimeFinderFactory::findPrimesAsync(config, collectingOptions()).take();
+        CHECK(result.primes.size() == 303);
+
+        config.divisionMode = "process";
+        CHECK(PrimeFinderFactory::findPrimesAsync(config, collectingOptions()).take().primes.size() == 303);
+    }
+}
+
+// Plugin that only implements the per-prime interface and records segment batches via the adapter.
+class PerPrimePlugin : public IPrintStrategy {
+public:
+    void printPrime(int prime, std::thread::id, std::chrono::system_clock::time_point) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        primes.push_back(prime);
+    }
+
+    void printPrimes(std::span<const int> batch, const SegmentInfo &info) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            segments.push_back(info.segment);
+        }
+        IPrintStrategy::printPrimes(batch, info);
+    }
+
+    void finalize(const SearchSummary &) override {}
+
+    std::mutex mutex;
+    std::vector<int> primes;
+    std::vector<Segment> segments;
+};
+
+TEST_CASE("Print Strategy - Segment Batches") {
+    SearchOptions options = collectingOptions();
+    options.segmentSize = 100;
+
+    SUBCASE("Every Segment Is Delivered Once, Empty Ones Included") {
+        for (auto strategy : std::vector<std::shared_ptr<ITaskDivisionStrategy>>{
+                 std::make_shared<RangeDivisionStrategy>(), std::make_shared<QueueDivisionStrategy>()}) {
+            auto plugin = std::make_shared<PerPrimePlugin>();
+            auto result = strategy->findPrimes(1000, 2, plugin, options);
+            std::sort(plugin->primes.begin(), plugin->primes.end());
+            std::sort(plugin->segments.begin(), plugin->segments.end(),
+                      [](const Segment &a, const Segment &b) { return a.index < b.index; });
+
+            CHECK(plugin->primes == PrimeUtils::getKnownPrimes(1000));
+            REQUIRE(plugin->segments.size() == 10);
+            for (size_t i = 0; i < plugin->segments.size(); ++i) {
+                CHECK(plugin->segments[i].index == static_cast<int>(i));
+            }
+        }
+    }
+
+    SUBCASE("Batch Strategy Collects Whole Segments") {
+        auto sink = std::make_shared<CountingPrintStrategy>();
+        auto primes = RangeDivisionStrategy().findPrimes(1000, 3, sink, options).primes;
+        CHECK(sink->calls == 168);
+        CHECK(primes.size() == 168);
+    }
+}
+
+TEST_CASE("Result Sinks - Streaming Without Materializing") {
+    SearchOptions options;
+    options.collectPrimes = false;
+    options.segmentSize = 1000;
+
+    SUBCASE("Count Sink") {
+        PrimeFinder<QueueDivisionStrategy, CountSink> finder;
+        auto result = finder.findPrimes(100000, 4, options);
+        CHECK(finder.sink().count() == 9592);
+        CHECK(result.primeCount == 9592);
+        CHECK(result.primes.empty());
+    }
+
+    SUBCASE("Vector Sink") {
+        PrimeFinder<RangeDivisionStrategy, VectorSink> finder;
+        finder.findPrimes(10000, 3, options);
+        CHECK(finder.sink().primes() == PrimeUtils::getKnownPrimes(10000));
+    }
+
+    SUBCASE("Bitmap Sink") {
+        PrimeFinder<RangeDivisionStrategy, BitmapSink> finder(10000);
+        finder.findPrimes(10000, 3, options);
+        CHECK(finder.sink().count() == 1229);
+        CHECK(finder.sink().contains(9973));
+        CHECK_FALSE(finder.sink().contains(9975));
+    }
+
+    SUBCASE("File Sink") {
+        {
+            PrimeFinder<QueueDivisionStrategy, FileSink> finder("result_sink_test.txt");
+            finder.findPrimes(5000, 2, options);
+        }
+        std::ifstream file("result_sink_test.txt");
+        std::vector<int> primes;
+        for (int prime; file >> prime;) {
+            primes.push_back(prime);
+        }
+        std::sort(primes.begin(), primes.end());
+        CHECK(primes == PrimeUtils::getKnownPrimes(5000));
+        std::remove("result_sink_test.txt");
+    }
+
+    SUBCASE("Vector Wrapper Still Collects") {
+        auto primes = RangeDivisionStrategy().findPrimes(1000, 2, std::make_shared<CountSink>());
+        CHECK(primes.size() == 168);
+    }
+}
+
+// Writer that records every block it receives.
+class RecordingWriter : public IOutputWriter {
+public:
+    void write(std::string_view lines) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        blocks.emplace_back(lines);
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> blocks;
+};
+
+TEST_CASE("Immediate Print Strategy - Buffered Output") {
+    SUBCASE("Lines Arrive In Whole-Line Blocks") {
+        auto writer = std::make_shared<RecordingWriter>();
+        auto strategy = std::make_shared<ImmediatePrintStrategy>(writer, 4096, std::chrono::milliseconds(1000));
+        SearchOptions options;
+        options.segmentSize = 500;
+        RangeDivisionStrategy().findPrimes(20000, 4, strategy, options);
+
+        size_t lines = 0;
+        size_t labelled = 0;
+        for (const std::string &block : writer->blocks) {
+            CHECK(block.back() == '\n');
+            lines += static_cast<size_t>(std::count(block.begin(), block.end(), '\n'));
+            labelled += block.find("found prime: 2 in segment done at ") != std::string::npos;
+        }
+        CHECK(lines == 2262 + 1); // Every prime plus the summary line
+        CHECK(writer->blocks.size() < 2262 / 10);
+        CHECK(writer->blocks.back().find("Total primes found: 2262") != std::string::npos);
+        // The stamp is the segment's completion time, and the line says so.
+        CHECK(labelled == 1);
+    }
+
+    SUBCASE("Stale Buffers Are Flushed In The Background") {
+        auto writer = std::make_shared<RecordingWriter>();
+        ImmediatePrintStrategy strategy(writer, 1 << 20, std::chrono::milliseconds(10));
+        std::vector<int> primes = {2, 3, 5};
+        strategy.printPrimes(primes, SegmentInfo{{0, 2, 5}, 0, std::this_thread::get_id(),
+                                                 std::chrono::system_clock::now()});
+
+        for (int attempt = 0; attempt < 200; ++attempt) {
+            {
+                std::lock_guard<std::mutex> lock(writer->mutex);
+                if (!writer->blocks.empty()) {
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        std::lock_guard<std::mutex> lock(writer->mutex);
+        REQUIRE(writer->blocks.size() == 1);
+        CHECK(std::count(writer->blocks[0].begin(), writer->blocks[0].end(), '\n') == 3);
+    }
+
+    SUBCASE("Fd Writer Writes Everything") {
+        FILE *file = std::tmpfile();
+        FdOutputWriter writer(fileno(file));
+        writer.write("2\n3\n");
+        writer.write("5\n");
+        CHECK(writer.bytesWritten() == 6);
+        std::fclose(file);
+    }
+}
+
+// Read everything from a pipe until it is closed.
+std::string readAll(int fd) {
+    std::string data;
+    char chunk[65536];
+    ssize_t received;
+    while ((received = read(fd, chunk, sizeof(chunk))) > 0) {
+        data.append(chunk, static_cast<size_t>(received));
+    }
+    return data;
+}
+
+// Write numbered 100-byte lines from several threads.
+void produceLines(IOutputWriter &writer, int threads, int linesPerThread) {
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; ++t) {
+        producers.emplace_back([&writer, t, linesPerThread]() {
+            for (int i = 0; i < linesPerThread; ++i) {
+                std::string line = std::to_string(t) + ":" + std::to_string(i) + ":";
+                line.resize(99, 'x');
+                writer.write(line + "\n");
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+}
+
+// Count lines, checking that none was torn.
+size_t countIntactLines(const std::string &data) {
+    std::istringstream lines(data);
+    size_t count = 0;
+    size_t torn = 0;
+    for (std::string line; std::getline(lines, line);) {
+        torn += line.size() != 99;
+        ++count;
+    }
+    CHECK(torn == 0);
+    return count;
+}
+
+TEST_CASE("Async Output Writer - Backpressure Policies") {
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+
+    SUBCASE("Block Keeps Every Line") {
+        std::thread reader;
+        std::string data;
+        {
+            AsyncOutputWriter writer(fds[1], BackpressurePolicy::BLOCK, 4);
+            reader = std::thread([&]() { data = readAll(fds[0]); });
+            produceLines(writer, 4, 2000);
+            writer.flush();
+        }
+        close(fds[1]);
+        reader.join();
+        CHECK(countIntactLines(data) == 8000);
+    }
+
+    SUBCASE("Drop Counts What It Discards") {
+        std::thread reader;
+        std::string data;
+        uint64_t dropped = 0;
+        {
+            // Nobody reads until producing is over, so the pipe and the ring fill up.
+            AsyncOutputWriter writer(fds[1], BackpressurePolicy::DROP, 4);
+            produceLines(writer, 2, 2000);
+            reader = std::thread([&]() { data = readAll(fds[0]); });
+            writer.flush();
+            dropped = writer.droppedLines();
+        }
+        close(fds[1]);
+        reader.join();
+        CHECK(dropped > 0);
+        CHECK(countIntactLines(data) + dropped == 4000);
+    }
+
+    SUBCASE("Spill Keeps Every Line") {
+        std::thread reader;
+        std::string data;
+        uint64_t spilled = 0;
+        {
+            AsyncOutputWriter writer(fds[1], BackpressurePolicy::SPILL, 4);
+            produceLines(writer, 2, 2000);
+            reader = std::thread([&]() { data = readAll(fds[0]); });
+            writer.flush();
+            spilled = writer.spilledBytes();
+        }
+        close(fds[1]);
+        reader.join();
+        CHECK(spilled > 0);
+        CHECK(countIntactLines(data) == 4000);
+
+        // Each producer's lines come out in the order it wrote them.
+        std::istringstream lines(data);
+        int next[2] = {0, 0};
+        size_t outOfOrder = 0;
+        for (std::string line; std::getline(lines, line);) {
+            int producer = line[0] - '0';
+            int index = std::stoi(line.substr(2));
+            outOfOrder += index != next[producer];
+            next[producer] = index + 1;
+        }
+        CHECK(outOfOrder == 0);
+    }
+
+    close(fds[0]);
+}
+
+TEST_CASE("Async Output Writer - Print Strategies") {
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    std::string data;
+    std::thread reader([&]() { data = readAll(fds[0]); });
+    {
+        auto writer = std::make_shared<AsyncOutputWriter>(fds[1]);
+        RangeDivisionStrategy().findPrimes(10000, 3, std::make_shared<ImmediatePrintStrategy>(writer));
+        RangeDivisionStrategy().findPrimes(100, 3, std::make_shared<BatchPrintStrategy>(writer));
+    }
+    close(fds[1]);
+    reader.join();
+    close(fds[0]);
+
+    CHECK(std::count(data.begin(), data.end(), '\n') == 1229 + 1 + 5); // Immediate lines and total, batch block
+    CHECK(data.find("[IMMEDIATE] Total primes found: 1229") != std::string::npos);
+    CHECK(data.find("[BATCH] Total primes found: 25") != std::string::npos);
+
+    // The async stage fronts standard output only; elsewhere the setting is rejected, not ignored.
+    Config config;
+    config.outputBackpressure = "block";
+    CHECK(std::dynamic_pointer_cast<AsyncOutputWriter>(PrimeFinderFactory::createOutputWriter(config)));
+    config.outputIo = "uring";
+    CHECK_THROWS_AS(PrimeFinderFactory::createOutputWriter(config), std::invalid_argument);
+    config.outputIo = "write";
+    config.outputFile = "backpressure_test.txt";
+    CHECK_THROWS_AS(PrimeFinderFactory::createOutputWriter(config), std::invalid_argument);
+    config.outputFile.clear();
+    config.printMode = "binary";
+    CHECK_THROWS_AS(PrimeFinderFactory::createOutputWriter(config), std::invalid_argument);
+}
+
+// Reference rendering of the batch output, one prime at a time as the strategy used to do it.
+std::string referenceBatchOutput(const std::vector<int> &primes) {
+    std::ostringstream out;
+    out << "[BATCH] All threads completed. Found primes:\n";
+    for (size_t i = 0; i < primes.size(); ++i) {
+        out << primes[i] << (i < primes.size() - 1 ? ", " : "") << ((i + 1) % 10 == 0 ? "\n" : "");
+    }
+    out << "\n[BATCH] Total primes found: " << primes.size() << "\n";
+    return out.str();
+}
+
+TEST_CASE("Batch Print Strategy - Fast Finalize") {
+    ColorUtils::setColorEnabled(false);
+
+    for (size_t count : {size_t{0}, size_t{7}, size_t{25}, size_t{1500001}}) {
+        // Deliver out of order in two segments; finalize sorts.
+        std::vector<int> numbers(count);
+        std::iota(numbers.begin(), numbers.end(), 2);
+        auto writer = std::make_shared<RecordingWriter>();
+        BatchPrintStrategy strategy(writer);
+        size_t half = count / 2;
+        SegmentInfo info{};
+        strategy.printPrimes(std::span<const int>(numbers).subspan(half), info);
+        strategy.printPrimes(std::span<const int>(numbers).first(half), info);
+        strategy.finalize(SearchSummary{count, true});
+
+        std::string output;
+        for (const std::string &block : writer->blocks) {
+            output += block;
+        }
+        CHECK(output == referenceBatchOutput(numbers));
+        if (count > 1000000) {
+            CHECK(writer->blocks.size() > 3); // Emitted in several large blocks
+        }
+    }
+
+    ColorUtils::setColorEnabled(true);
+}
+
+TEST_CASE("Binary Print Strategy - Encodings") {
+    std::vector<int> expected = PrimeUtils::findPrimesInRange(2, 200000);
+
+    size_t sizes[3];
+    int index = 0;
+    for (BinaryEncoding encoding : {BinaryEncoding::U32, BinaryEncoding::U64, BinaryEncoding::VARINT}) {
+        auto writer = std::make_shared<RecordingWriter>();
+        auto sink = std::make_shared<BinaryPrintStrategy>(writer, encoding);
+        RangeDivisionStrategy().findPrimes(200000, 4, sink);
+
+        std::string stream;
+        for (const std::string &block : writer->blocks) {
+            stream += block;
+        }
+        CHECK(stream.substr(0, 4) == "PRMB");
+        CHECK(stream.size() == sink->bytesWritten());
+
+        // Blocks follow segment completion order; each is ascending on its own.
+        std::vector<int> decoded = BinaryPrintStrategy::decode(stream);
+        std::sort(decoded.begin(), decoded.end());
+        CHECK(decoded == expected);
+        sizes[index++] = stream.size();
+    }
+
+    // Text output needs a line of about eight bytes per prime.
+    CHECK(sizes[0] < expected.size() * 4 + 1024);
+    CHECK(sizes[1] < expected.size() * 8 + 1024);
+    CHECK(sizes[2] < expected.size() * 2);
+
+    CHECK(BinaryPrintStrategy::parseEncoding("U64") == BinaryEncoding::U64);
+    CHECK_THROWS_AS(BinaryPrintStrategy::parseEncoding("text"), std::invalid_argument);
+    CHECK_THROWS_AS(BinaryPrintStrategy::decode("PRMX\x01\x03\0\0"), std::invalid_argument);
+    CHECK(PrimeFinderFactory::parsePrintMode("binary") == PrintMode::BINARY);
+}
+
+TEST_CASE("Binary Print Strategy - File Output") {
+    std::string path = "/tmp/prime_finder_test_binary_" + std::to_string(getpid()) + ".bin";
+    Config config;
+    config.upperLimit = 100000;
+    config.threads = 3;
+    config.printMode = "binary";
+    config.binaryEncoding = "u32";
+    config.outputFile = path;
+
+    SearchOptions options;
+    options.collectPrimes = false;
+    PrimeSearchResult result = PrimeFinderFactory::findPrimesAsync(config, options).take();
+    CHECK(result.primeCount == 9592);
+
+    std::ifstream file(path, std::ios::binary);
+    std::string stream((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<int> decoded = BinaryPrintStrategy::decode(stream);
+    CHECK(decoded.size() == 9592);
+
+    // Truncating a block is detected.
+    CHECK_THROWS_AS(BinaryPrintStrategy::decode(stream.substr(0, stream.size() - 1)), std::invalid_argument);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("File Print Strategy - Ordered Parallel Writes") {
+    ColorUtils::setColorEnabled(false);
+    std::string path = "/tmp/prime_finder_test_ordered_" + std::to_string(getpid()) + ".txt";
+
+    // Queue division finishes segments out of order.
+    for (int upperLimit : {0, 1000, 8000000}) {
+        auto status = std::make_shared<RecordingWriter>();
+        auto sink = std::make_shared<FilePrintStrategy>(path, status);
+        std::vector<int> primes = QueueDivisionStrategy().findPrimes(upperLimit, 4, sink);
+
+        std::ifstream file(path);
+        std::vector<int> written;
+        for (int prime; file >> prime;) {
+            written.push_back(prime);
+        }
+        std::sort(primes.begin(), primes.end());
+        CHECK(written == primes);
+        REQUIRE(status->blocks.size() == 1);
+        std::string wrote = "Wrote " + std::to_string(primes.size()) + " primes";
+        CHECK(status->blocks[0].find(wrote) != std::string::npos);
+    }
+
+    // A segment is written as soon as every earlier one is placed, not at finalize; segments left
+    // behind a gap by a stopped search are written by finalize.
+    {
+        auto fileText = [&path]() {
+            std::ifstream file(path, std::ios::binary);
+            return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        };
+        auto segment = [](int index) {
+            return SegmentInfo{{index, 0, 0}, 0, std::this_thread::get_id(), {}};
+        };
+        std::vector<int> first = {2, 3, 5, 7};
+        std::vector<int> second = {11, 13};
+        std::vector<int> late = {23};
+        FilePrintStrategy direct(path, std::make_shared<RecordingWriter>());
+        direct.printPrimes(second, segment(1));
+        CHECK(fileText().empty());
+        direct.printPrimes({}, segment(2));
+        direct.printPrimes(first, segment(0));
+        CHECK(fileText() == "2\n3\n5\n7\n11\n13\n");
+        direct.printPrimes(late, segment(4));
+        direct.finalize(SearchSummary{7, false});
+        CHECK(fileText() == "2\n3\n5\n7\n11\n13\n23\n");
+    }
+
+    CHECK_THROWS_AS(FilePrintStrategy("/nonexistent/dir/primes.txt"), std::runtime_error);
+    CHECK(PrimeFinderFactory::parsePrintMode("file") == PrintMode::TEXT_FILE);
+    std::remove(path.c_str());
+    ColorUtils::setColorEnabled(true);
+}
+
+TEST_CASE("Count Only - Sieve Popcount Path") {
+    static_assert(CountingSink<CountSink> && CountingSink<CountPrintStrategy>);
+    static_assert(!CountingSink<VectorSink>);
+
+    std::vector<uint64_t> scratch;
+    std::vector<int> basePrimes = PrimeUtils::basePrimesFor(100000);
+    CHECK(PrimeUtils::countPrimesInSegment(0, 100001, basePrimes, scratch) == 9592);
+    CHECK(PrimeUtils::countPrimesInSegment(99990, 100001, basePrimes, scratch) == 1); // 99991
+    CHECK(PrimeUtils::countPrimesInSegment(2, 3, basePrimes, scratch) == 1);
+
+    // Both division strategies count the same totals without returning any primes.
+    for (int upperLimit : {0, 2, 97, 1000000}) {
+        size_t expected = PrimeUtils::getKnownPrimes(upperLimit).size();
+        PrimeSearchResult range = PrimeFinder<RangeDivisionStrategy, CountSink>()
+                                      .findPrimesAsync(upperLimit, 3)
+                                      .take();
+        PrimeSearchResult queue = PrimeFinder<QueueDivisionStrategy, CountSink>()
+                                      .findPrimesAsync(upperLimit, 3)
+                                      .take();
+        CHECK(range.primeCount == expected);
+        CHECK(queue.primeCount == expected);
+        CHECK(range.primes.empty());
+    }
+
+    // Asking for the primes takes the enumerating path even with a counting sink.
+    SearchOptions collect;
+    collect.collectPrimes = true;
+    collect.segmentSize = 30;
+    PrimeFinder<RangeDivisionStrategy, CountPrintStrategy> rangeCount(std::make_shared<RecordingWriter>());
+    PrimeFinder<QueueDivisionStrategy, CountSink> queueCount;
+    for (const PrimeSearchResult &result :
+         {rangeCount.findPrimes(100, 2, collect), queueCount.findPrimes(100, 2, collect)}) {
+        CHECK(result.primeCount == 25);
+        CHECK(result.primes == PrimeUtils::getKnownPrimes(100));
+    }
+
+    ColorUtils::setColorEnabled(false);
+    Config config;
+    config.upperLimit = 1000000;
+    config.printMode = "count";
+    auto writer = std::make_shared<RecordingWriter>();
+    PrimeSearchResult result = PrimeFinderFactory::findPrimesAsync(config, SearchOptions{}, writer).take();
+    CHECK(result.primeCount == 78498);
+    REQUIRE(writer->blocks.size() == 1);
+    CHECK(writer->blocks[0].find("[COUNT] Total primes found: 78498 in ") == 0);
+    ColorUtils::setColorEnabled(true);
+}
+
+TEST_CASE("Structured Print Strategy - NDJSON and CSV") {
+    Config config;
+    config.upperLimit = 100000;
+    config.threads = 3;
+
+    // NDJSON: one prime object per line, then the summary object.
+    config.printMode = "ndjson";
+    auto json = std::make_shared<RecordingWriter>();
+    PrimeFinderFactory::findPrimesAsync(config, SearchOptions{}, json).take();
+    std::string jsonText;
+    for (const std::string &block : json->blocks) {
+        jsonText += block;
+    }
+    std::vector<int> jsonPrimes;
+    std::istringstream jsonLines(jsonText);
+    std::string summaryLine;
+    for (std::string line; std::getline(jsonLines, line);) {
+        if (line.starts_with("{\"type\":\"prime\",\"worker\":")) {
+            jsonPrimes.push_back(std::stoi(line.substr(line.find("\"value\":") + 8)));
+        } else {
+            summaryLine = line;
+        }
+    }
+    std::sort(jsonPrimes.begin(), jsonPrimes.end());
+    CHECK(jsonPrimes == PrimeUtils::getKnownPrimes(100000));
+    CHECK(summaryLine.starts_with("{\"type\":\"summary\",\"primes\":9592,\"complete\":true,\"elapsed_ms\":"));
+    CHECK(summaryLine.find("\"config\":{\"upper_limit\":100000,\"threads\":3,\"print_mode\":\"ndjson\"") !=
+          std::string::npos);
+    CHECK(summaryLine.find("\"workers\":[{\"worker\":0,") != std::string::npos);
+
+    // CSV: header, prime rows, then summary, config and worker rows.
+    config.printMode = "csv";
+    config.divisionMode = "queue";
+    auto csv = std::make_shared<RecordingWriter>();
+    PrimeFinderFactory::findPrimesAsync(config, SearchOptions{}, csv).take();
+    std::string csvText;
+    for (const std::string &block : csv->blocks) {
+        csvText += block;
+    }
+    CHECK(csvText.starts_with("record,key,value\n"));
+    size_t primeRows = 0;
+    uint64_t workerPrimes = 0;
+    std::istringstream csvLines(csvText);
+    for (std::string line; std::getline(csvLines, line);) {
+        primeRows += line.starts_with("prime,");
+        if (line.starts_with("worker_primes,")) {
+            workerPrimes += std::stoull(line.substr(line.rfind(',') + 1));
+        }
+    }
+    CHECK(primeRows == 9592);
+    CHECK(workerPrimes == 9592);
+    CHECK(csvText.find("summary,primes,9592\nsummary,complete,true\n") != std::string::npos);
+    CHECK(csvText.find("config,division_mode,queue\n") != std::string::npos);
+
+    CHECK(PrimeFinderFactory::parsePrintMode("NDJSON") == PrintMode::NDJSON);
+    CHECK(PrimeFinderFactory::parsePrintMode("csv") == PrintMode::CSV);
+}
+
+TEST_CASE("Ordered Print Strategy - Ascending Lines Within The Window") {
+    ColorUtils::setColorEnabled(false);
+
+    // Collect the primes printed on "found prime:" lines, in output order.
+    auto printedPrimes = [](const RecordingWriter &writer) {
+        std::string text;
+        for (const std::string &block : writer.blocks) {
+            text += block;
+        }
+        std::vector<int> primes;
+        std::istringstream lines(text);
+        for (std::string line; std::getline(lines, line);) {
+            size_t found = line.find("found prime: ");
+            if (found != std::string::npos) {
+                primes.push_back(std::stoi(line.substr(found + 13)));
+            }
+        }
+        return primes;
+    };
+
+    SUBCASE("Queue division with a small window") {
+        auto writer = std::make_shared<RecordingWriter>();
+        PrimeFinder<QueueDivisionStrategy, OrderedPrintStrategy> finder(writer, 4);
+        SearchOptions options;
+        options.segmentSize = 1000;
+        PrimeSearchResult result = finder.findPrimes(100000, 4, options);
+        CHECK(result.complete);
+        CHECK(printedPrimes(*writer) == PrimeUtils::getKnownPrimes(100000));
+        CHECK(finder.sink().peakHeldSegments() <= 4);
+        CHECK(writer->blocks.back().find("[ORDERED] Total primes found: 9592") != std::string::npos);
+    }
+
+    SUBCASE("Queue division through the factory; range division is rejected") {
+        Config config;
+        config.upperLimit = 50000;
+        config.threads = 3;
+        config.printMode = "ordered";
+        auto writer = std::make_shared<RecordingWriter>();
+        CHECK_THROWS_AS(PrimeFinderFactory::findPrimesAsync(config, SearchOptions{}, writer),
+                        std::invalid_argument);
+        CHECK_THROWS_AS((PrimeFinder<RangeDivisionStrategy, OrderedPrintStrategy>(writer).findPrimes(100, 2)),
+                        std::invalid_argument);
+
+        config.divisionMode = "queue";
+        PrimeFinderFactory::findPrimesAsync(config, SearchOptions{}, writer).take();
+        CHECK(printedPrimes(*writer) == PrimeUtils::getKnownPrimes(50000));
+        CHECK(PrimeFinderFactory::parsePrintMode("Ordered") == PrintMode::ORDERED);
+    }
+
+    SUBCASE("A stopped run returns instead of waiting for the window") {
+        auto writer = std::make_shared<RecordingWriter>();
+        PrimeFinder<QueueDivisionStrategy, OrderedPrintStrategy> finder(writer, 1);
+        SearchOptions options;
+        options.segmentSize = 1000;
+        options.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+        PrimeSearchResult result = finder.findPrimes(20000000, 4, options);
+        CHECK_FALSE(result.complete);
+        std::vector<int> printed = printedPrimes(*writer);
+        CHECK(std::is_sorted(printed.begin(), printed.end()));
+    }
+
+    ColorUtils::setColorEnabled(true);
+}
+
+TEST_CASE("ColorUtils - Escape Table And Append") {
+    static_assert(ColorUtils::RESET == "\033[0m");
+
+    // Tests never run on a terminal, so colors stay off even when requested.
+    ColorUtils::setColorEnabled(true);
+    CHECK_FALSE(ColorUtils::isColorEnabled());
+    CHECK(ColorUtils::code(ColorUtils::Style::ERROR).empty());
+    CHECK(ColorUtils::resetColor().empty());
+    CHECK(ColorUtils::success("done") == "done");
+    CHECK(ColorUtils::colorize("plain", ColorUtils::RED) == "plain");
+
+    std::string out = "[";
+    ColorUtils::append(out, "thread", ColorUtils::Style::THREAD);
+    ColorUtils::append(out, "]", ColorUtils::Style::BOLD);
+    CHECK(out == "[thread]");
+}
+
+TEST_CASE("EventClock - Monotonic Timestamps And Elapsed Rendering") {
+    EventClock::TimePoint first = EventClock::now();
+    EventClock::TimePoint second = EventClock::now();
+    CHECK(second >= first);
+    CHECK(EventClock::sinceStart(second) >= EventClock::sinceStart(first));
+    CHECK(EventClock::sinceStart(first) >= std::chrono::nanoseconds(0));
+
+    // Elapsed time is seconds plus exactly nine zero-padded nanosecond digits.
+    EventClock::TimePoint later = first - EventClock::sinceStart(first) + std::chrono::nanoseconds(3'000'004'005);
+    std::string elapsed;
+    EventClock::appendElapsed(elapsed, later);
+    CHECK(elapsed == "+3.000004005s");
+
+    // The calendar text of a second is rendered once and reused for every event within it.
+    std::string sameSecond;
+    EventClock::appendWallClock(sameSecond, later);
+    EventClock::appendWallClock(sameSecond, later + std::chrono::nanoseconds(1));
+    CHECK(sameSecond.size() % 2 == 0);
+    CHECK(sameSecond.substr(0, sameSecond.size() / 2) == sameSecond.substr(sameSecond.size() / 2));
+}
+
+TEST_CASE("Live Print Strategy - Frames And Full Results") {
+    ColorUtils::setColorEnabled(false);
+
+    SUBCASE("Frames are rate limited and end with the total") {
+        auto writer = std::make_shared<RecordingWriter>();
+        PrimeFinder<QueueDivisionStrategy, LivePrintStrategy> finder(writer, nullptr, 1000);
+        PrimeSearchResult result = finder.findPrimes(200000, 3);
+        CHECK(result.complete);
+
+        std::string text;
+        for (const std::string &block : writer->blocks) {
+            text += block;
+        }
+        // Not a terminal, so every frame is its own line; the last frame shows the final count.
+        CHECK(finder.sink().framesDrawn() >= 1);
+        CHECK(text.find("[LIVE] 17984 primes, ") != std::string::npos);
+        CHECK(text.find("largest 199999") != std::string::npos);
+        CHECK(text.ends_with("[LIVE] Total primes found: 17984\n"));
+        CHECK(std::count(text.begin(), text.end(), '\n') == static_cast<long>(finder.sink().framesDrawn() + 1));
+    }
+
+    SUBCASE("Full results go to output_file through the factory") {
+        Config config;
+        config.upperLimit = 20000;
+        config.threads = 2;
+        config.printMode = "live";
+        config.outputFile = "live_full_results_test.txt";
+        auto writer = std::make_shared<RecordingWriter>();
+        PrimeFinderFactory::findPrimesAsync(config, SearchOptions{}, writer).take();
+
+        std::ifstream file(config.outputFile);
+        std::vector<int> written;
+        for (int prime; file >> prime;) {
+            written.push_back(prime);
+        }
+        CHECK(written == PrimeUtils::getKnownPrimes(20000));
+        std::remove(config.outputFile.c_str());
+        CHECK(PrimeFinderFactory::parsePrintMode("LIVE") == PrintMode::LIVE);
+    }
+
+    SUBCASE("Status messages can be muted while the status line is drawn") {
+        std::ostringstream captured;
+        std::streambuf *original = std::cout.rdbuf(captured.rdbuf());
+        Console::setStatusMuted(true);
+        Console::status() << "[THREAD 1] Found 3 primes" << std::endl;
+        CHECK(Console::status().good());
+        Console::setStatusMuted(false);
+        Console::status() << "done" << std::endl;
+        std::cout.rdbuf(original);
+        CHECK(captured.str() == "done\n");
+    }
+
+    ColorUtils::setColorEnabled(true);
+}
+
+TEST_CASE("Uring Output Writer - In-Flight Buffers Keep Every Byte In Order") {
+    std::string expected;
+    for (int i = 0; i < 50000; ++i) {
+        expected += std::to_string(i) + "\n";
+    }
+    auto readFile = [](const char *path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    };
+
+    // Small buffers force many submissions, several in flight, through io_uring and the thread fallback.
+    for (bool useUring : {true, false}) {
+        const char *path = "uring_writer_test.txt";
+        int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        REQUIRE(fd >= 0);
+        {
+            UringOutputWriter writer(fd, 4096, 3, useUring);
+            if (!useUring) {
+                CHECK_FALSE(writer.usingUring());
+            }
+            for (size_t pos = 0; pos < expected.size(); pos += 7000) {
+                writer.write(std::string_view(expected).substr(pos, 7000));
+            }
+            writer.flush();
+            CHECK(writer.bytesWritten() == expected.size());
+        }
+        ::close(fd);
+        CHECK(readFile(path) == expected);
+        std::remove(path);
+    }
+
+    // A pipe cannot seek, so writes go out one at a time and arrive in order.
+    int pipeFds[2];
+    REQUIRE(::pipe(pipeFds) == 0);
+    std::string received;
+    std::thread reader([&]() {
+        char chunk[4096];
+        for (ssize_t n; (n = ::read(pipeFds[0], chunk, sizeof(chunk))) > 0;) {
+            received.append(chunk, static_cast<size_t>(n));
+        }
+    });
+    {
+        UringOutputWriter writer(pipeFds[1], 1000);
+        writer.write(expected);
+        writer.write("tail\n");
+    }
+    ::close(pipeFds[1]);
+    reader.join();
+    ::close(pipeFds[0]);
+    CHECK(received == expected + "tail\n");
+
+    // A block written while nothing is in flight reaches the reader without a flush.
+    for (bool useUring : {true, false}) {
+        REQUIRE(::pipe(pipeFds) == 0);
+        UringOutputWriter writer(pipeFds[1], 1 << 20, 4, useUring);
+        writer.write("2\n3\n5\n");
+        pollfd readable{pipeFds[0], POLLIN, 0};
+        REQUIRE(::poll(&readable, 1, 5000) == 1);
+        char chunk[16];
+        ssize_t n = ::read(pipeFds[0], chunk, sizeof(chunk));
+        CHECK(std::string(chunk, static_cast<size_t>(std::max<ssize_t>(n, 0))) == "2\n3\n5\n");
+        writer.flush();
+        ::close(pipeFds[1]);
+        ::close(pipeFds[0]);
+    }
+
+    // Configured through output_io.
+    Config config;
+    config.outputIo = "uring";
+    CHECK(std::dynamic_pointer_cast<UringOutputWriter>(PrimeFinderFactory::createOutputWriter(config)));
+    config.outputIo = "mmap";
+    CHECK_THROWS_AS(PrimeFinderFactory::createOutputWriter(config), std::invalid_argument);
+
+    // Modes that write their own files are checked too instead of ignoring the setting.
+    for (std::string mode : {"file", "live", "sharded"}) {
+        config.printMode = mode;
+        config.outputIo = "mmap";
+        CHECK_THROWS_AS(PrimeFinderFactory::createOutputWriter(config), std::invalid_argument);
+        config.outputIo = "uring";
+        CHECK_THROWS_AS(PrimeFinderFactory::createOutputWriter(config), std::invalid_argument);
+        config.outputIo = "write";
+        CHECK(PrimeFinderFactory::createOutputWriter(config));
+    }
+}
+
+TEST_CASE("Sharded Print Strategy - Shards, Manifest And Resume") {
+    CHECK(ShardedPrintStrategy::crc32("123456789") == 0xCBF43926u);
+    CHECK(ShardedPrintStrategy::parseFormat("u32") == ShardFormat::U32);
+    CHECK_THROWS_AS(ShardedPrintStrategy::parseFormat("csv"), std::invalid_argument);
+
+    const std::string directory = "sharded_test_dir";
+    std::filesystem::remove_all(directory);
+    SearchOptions options;
+    options.segmentSize = 10000;
+
+    // Read every shard named in the manifest back, in manifest order.
+    auto readShards = [&](std::vector<std::string> &files) {
+        std::ifstream manifest(directory + "/manifest.tsv");
+        std::vector<int> primes;
+        for (std::string line; std::getline(manifest, line);) {
+            if (line.starts_with("#")) {
+                continue;
+            }
+            std::istringstream fields(line);
+            std::string file;
+            fields >> file;
+            files.push_back(file);
+            std::ifstream shard(directory + "/" + file);
+            for (int prime; shard >> prime;) {
+                primes.push_back(prime);
+            }
+        }
+        return primes;
+    };
+
+    for (bool rerun : {false, true}) {
+        auto writer = std::make_shared<RecordingWriter>();
+        PrimeFinder<QueueDivisionStrategy, ShardedPrintStrategy> finder(directory, ShardFormat::TEXT, writer);
+        PrimeSearchResult result = finder.findPrimes(100000, 3, options);
+        CHECK(result.primeCount == 9592);
+
+        std::vector<std::string> files;
+        CHECK(readShards(files) == PrimeUtils::getKnownPrimes(100000));
+        CHECK(files.size() == 10);
+        // A rerun reuses every shard instead of computing it.
+        CHECK(finder.sink().shardsReused() == (rerun ? 10u : 0u));
+    }
+
+    // A corrupted shard fails its checksum and is computed again; the others are still reused.
+    {
+        std::ofstream corrupt(directory + "/primes_0000000002_0000010001.txt", std::ios::app);
+        corrupt << "4\n";
+    }
+    PrimeFinder<QueueDivisionStrategy, ShardedPrintStrategy> finder(directory, ShardFormat::TEXT,
+                                                                   std::make_shared<RecordingWriter>());
+    CHECK(finder.findPrimes(100000, 3, options).primeCount == 9592);
+    CHECK(finder.sink().shardsReused() == 9);
+    std::vector<std::string> files;
+    CHECK(readShards(files) == PrimeUtils::getKnownPrimes(100000));
+
+    // A manifest line with a malformed checksum is skipped, and only its shard is computed again.
+    std::string manifest;
+    {
+        std::ifstream in(directory + "/manifest.tsv");
+        std::stringstream contents;
+        contents << in.rdbuf();
+        manifest = contents.str();
+    }
+    size_t firstEnd = manifest.find('\n', manifest.find("primes_0000000002"));
+    manifest.replace(manifest.rfind('\t', firstEnd) + 1, firstEnd - manifest.rfind('\t', firstEnd) - 1, "zz");
+    std::ofstream(directory + "/manifest.tsv") << manifest;
+    PrimeFinder<QueueDivisionStrategy, ShardedPrintStrategy> reread(directory, ShardFormat::TEXT,
+                                                                   std::make_shared<RecordingWriter>());
+    CHECK(reread.findPrimes(100000, 3, options).primeCount == 9592);
+    CHECK(reread.sink().shardsReused() == 9);
+
+    // The manifest is rewritten as shards complete, so a run killed before finalize keeps its shards,
+    // and a rerun killed early still lists the shards of the run before it.
+    std::filesystem::remove_all(directory);
+    for (int index : {0, 1}) {
+        ShardedPrintStrategy strategy(directory, ShardFormat::TEXT, std::make_shared<RecordingWriter>());
+        std::this_thread::sleep_for(ShardedPrintStrategy::MANIFEST_INTERVAL);
+        Segment segment{index, 2 + index * 10000, 10001 + index * 10000};
+        std::vector<int> primes = PrimeUtils::findPrimesInRange(segment.start, segment.end);
+        strategy.printPrimes(primes, SegmentInfo{segment, 0, std::this_thread::get_id(), {}});
+
+        files.clear();
+        CHECK(readShards(files) == PrimeUtils::getKnownPrimes(10001 + index * 10000));
+        CHECK(files.size() == static_cast<size_t>(index + 1));
+        CHECK(!std::filesystem::exists(directory + "/manifest.tsv.tmp"));
+    }
+
+    std::filesystem::remove_all(directory);
+}